@@ -25,7 +25,12 @@
 QString AbstractVoiceCallHandler::statusText() const
 {
     TRACE
-    switch(status())
+    return statusText(status());
+}
+
+QString AbstractVoiceCallHandler::statusText(VoiceCallStatus status)
+{
+    switch(status)
     {
         case STATUS_ACTIVE:
             return "active";
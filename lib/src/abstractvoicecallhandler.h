@@ -90,6 +90,7 @@ public:
 
     virtual bool isOngoing() const;
     QString statusText() const;
+    static QString statusText(VoiceCallStatus status);
 
 Q_SIGNALS:
     void statusChanged(VoiceCallStatus);
@@ -32,10 +32,18 @@ class AbstractVoiceCallManagerPlugin : public QObject
     Q_PROPERTY(QString pluginId READ pluginId)
 
 public:
+    // Work of deferred plugins, given to VoiceCallManagerInterface::schedule(),
+    // waits until no call is being set up.
+    enum Priority {
+        PRIORITY_CRITICAL,
+        PRIORITY_DEFERRED
+    };
+
     explicit AbstractVoiceCallManagerPlugin(QObject *parent = 0) : QObject(parent) {/*...*/}
     virtual ~AbstractVoiceCallManagerPlugin() {/*...*/}
 
     virtual QString pluginId() const = 0;
+    virtual Priority priority() const { return PRIORITY_CRITICAL; }
 
 public Q_SLOTS:
     virtual bool initialize() = 0;
@@ -23,10 +23,35 @@
 
 #include <QLoggingCategory>
 
+#include "voicecalltrace.h"
+
 Q_DECLARE_LOGGING_CATEGORY(voicecall)
 
+// Trace points are logged through the org.nemomobile.voicecall category,
+// e.g. with QT_LOGGING_RULES="org.nemomobile.voicecall.info=true", and
+// recorded in binary form unless VOICECALL_TRACE_RECORDS is 0. They are
+// compiled out at level 0:
+//   qmake DEFINES+=VOICECALL_TRACE_LEVEL=0
+#ifndef VOICECALL_TRACE_LEVEL
+#define VOICECALL_TRACE_LEVEL 1
+#endif
+#ifndef VOICECALL_TRACE_RECORDS
+#define VOICECALL_TRACE_RECORDS 1
+#endif
+
 #define WARNING_T(message, ...) qCWarning(voicecall, "%s " message, Q_FUNC_INFO, ##__VA_ARGS__)
-#define TRACE qCInfo(voicecall, "%s:%d %p", Q_FUNC_INFO, __LINE__, this);
+#if VOICECALL_TRACE_LEVEL <= 0
+#define TRACE
+#else
+#if VOICECALL_TRACE_RECORDS
+#define TRACE_RECORD { \
+    static const VoiceCallTrace::Site voicecall_trace_site = { Q_FUNC_INFO, __LINE__, {-1} }; \
+    VoiceCallTrace::record(&voicecall_trace_site, this); }
+#else
+#define TRACE_RECORD
+#endif
+#define TRACE TRACE_RECORD qCInfo(voicecall, "%s:%d %p", Q_FUNC_INFO, __LINE__, this);
+#endif
 #define DEBUG_T(message, ...) qCDebug(voicecall, "%s " message, Q_FUNC_INFO, ##__VA_ARGS__)
 
 #endif // COMMON_H
@@ -5,14 +5,20 @@ QT = core
 
 HEADERS += \
     common.h \
+    voicecalltrace.h \
     voicecallmanagerinterface.h \
+    voicecallchangeset.h \
+    voicecallsnapshot.h \
+    voicecallhandlerid.h \
     abstractvoicecallhandler.h \
     abstractvoicecallprovider.h \
     abstractvoicecallmanagerplugin.h \
 
 SOURCES += \
     abstractvoicecallhandler.cpp \
-    common.cpp
+    common.cpp \
+    voicecallhandlerid.cpp \
+    voicecalltrace.cpp
 
 target.path = $$[QT_INSTALL_LIBS]
 
@@ -0,0 +1,98 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef VOICECALLCHANGESET_H
+#define VOICECALLCHANGESET_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QStringList>
+#include <QVector>
+
+#include "voicecallsnapshot.h"
+
+/*
+  The changes made to the calls of the manager during one event loop
+  turn. A call added and removed within the same turn is listed as
+  both, calls that are added also get the properties they changed
+  meanwhile.
+  Each call listed comes with a snapshot of its latest state, the one
+  of a removed call being taken on removal, and with the statuses it
+  went through during the turn, oldest first, the latest status being
+  the one of the snapshot. Snapshots also carry the ids interned for
+  the calls, so that receivers need not look them up by string.
+*/
+struct VoiceCallChangeSet
+{
+    enum Property {
+        PROPERTY_STATUS = 0x001,
+        PROPERTY_LINE_ID = 0x002,
+        PROPERTY_STARTED_AT = 0x004,
+        PROPERTY_DURATION = 0x008,
+        PROPERTY_EMERGENCY = 0x010,
+        PROPERTY_MULTIPARTY = 0x020,
+        PROPERTY_FORWARDED = 0x040,
+        PROPERTY_REMOTE_HELD = 0x080,
+        PROPERTY_PARENT_HANDLER_ID = 0x100,
+        PROPERTY_CHILD_CALLS = 0x200,
+        PROPERTY_ALL = 0x3ff
+    };
+    Q_DECLARE_FLAGS(Properties, Property)
+
+    QStringList added;
+    QStringList removed;
+    QHash<QString, Properties> changed;
+    bool activeVoiceCallChanged = false;
+    QHash<QString, VoiceCallSnapshot> snapshots;
+    QHash<QString, QVector<AbstractVoiceCallHandler::VoiceCallStatus> > statuses;
+
+    // The interned id of a call listed, null if it has none.
+    VoiceCallHandlerId id(const QString &handlerId) const
+    {
+        QHash<QString, VoiceCallSnapshot>::const_iterator it = snapshots.constFind(handlerId);
+        return it != snapshots.constEnd() ? it->id : VoiceCallHandlerId();
+    }
+
+    bool voiceCallsChanged() const
+    {
+        return !added.isEmpty() || !removed.isEmpty();
+    }
+
+    // Whether any call changed one of the given properties.
+    bool hasChanged(Properties properties) const
+    {
+        for (QHash<QString, Properties>::const_iterator it = changed.constBegin();
+             it != changed.constEnd(); ++it) {
+            if (it.value() & properties)
+                return true;
+        }
+        return false;
+    }
+
+    bool isEmpty() const
+    {
+        return !voiceCallsChanged() && changed.isEmpty() && !activeVoiceCallChanged;
+    }
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(VoiceCallChangeSet::Properties)
+Q_DECLARE_METATYPE(VoiceCallChangeSet)
+
+#endif // VOICECALLCHANGESET_H
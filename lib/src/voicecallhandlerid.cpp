@@ -0,0 +1,185 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "voicecallhandlerid.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QUuid>
+
+struct VoiceCallHandlerIdData
+{
+    quint64 hi;
+    quint64 lo;
+    uint hash;
+    QAtomicInt ref;
+    QString id;
+    QString objectPath;
+};
+
+namespace {
+
+struct Key
+{
+    quint64 hi;
+    quint64 lo;
+
+    bool operator==(const Key &other) const { return hi == other.hi && lo == other.lo; }
+};
+
+uint qHash(const Key &key, uint seed = 0)
+{
+    const quint64 mixed = (key.hi ^ (key.lo * Q_UINT64_C(0x9e3779b97f4a7c15)));
+    return uint(mixed ^ (mixed >> 32)) ^ seed;
+}
+
+const char HexDigits[] = "0123456789abcdef";
+const QLatin1String CallsPath("/calls/");
+
+void format(quint64 value, QChar *out)
+{
+    for (int i = 15; i >= 0; i--) {
+        out[i] = QLatin1Char(HexDigits[value & 0xf]);
+        value >>= 4;
+    }
+}
+
+bool parse(const QChar *in, quint64 *value)
+{
+    quint64 result = 0;
+    for (int i = 0; i < 16; i++) {
+        const ushort c = in[i].unicode();
+        int digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+        result = (result << 4) | quint64(digit);
+    }
+    *value = result;
+    return true;
+}
+
+// Entries leave the table with their last reference.
+QMutex s_lock;
+QHash<Key, VoiceCallHandlerIdData *> *s_table = 0;
+
+}
+
+VoiceCallHandlerIdData *VoiceCallHandlerId::intern(quint64 hi, quint64 lo)
+{
+    const Key key = { hi, lo };
+    QMutexLocker locker(&s_lock);
+    if (!s_table)
+        s_table = new QHash<Key, VoiceCallHandlerIdData *>;
+
+    VoiceCallHandlerIdData *data = s_table->value(key);
+    if (data) {
+        // An entry whose last reference is being dropped is replaced.
+        int ref = data->ref.load();
+        while (ref > 0 && !data->ref.testAndSetOrdered(ref, ref + 1))
+            ref = data->ref.load();
+        if (ref > 0)
+            return data;
+    }
+
+    data = new VoiceCallHandlerIdData;
+    data->hi = hi;
+    data->lo = lo;
+    data->hash = qHash(key);
+    data->ref.store(1);
+    data->id.resize(32);
+    format(hi, data->id.data());
+    format(lo, data->id.data() + 16);
+    data->objectPath.reserve(CallsPath.size() + 32);
+    data->objectPath.append(CallsPath);
+    data->objectPath.append(data->id);
+    s_table->insert(key, data);
+    return data;
+}
+
+VoiceCallHandlerId::VoiceCallHandlerId(const VoiceCallHandlerId &other)
+    : d(other.d)
+{
+    if (d)
+        d->ref.ref();
+}
+
+VoiceCallHandlerId::~VoiceCallHandlerId()
+{
+    if (d && !d->ref.deref()) {
+        {
+            QMutexLocker locker(&s_lock);
+            const Key key = { d->hi, d->lo };
+            QHash<Key, VoiceCallHandlerIdData *>::iterator it = s_table->find(key);
+            if (it != s_table->end() && it.value() == d)
+                s_table->erase(it);
+        }
+        delete d;
+    }
+}
+
+VoiceCallHandlerId &VoiceCallHandlerId::operator=(const VoiceCallHandlerId &other)
+{
+    VoiceCallHandlerId copy(other);
+    qSwap(d, copy.d);
+    return *this;
+}
+
+VoiceCallHandlerId VoiceCallHandlerId::generate()
+{
+    const QUuid uuid = QUuid::createUuid();
+    quint64 lo = 0;
+    for (int i = 0; i < 8; i++)
+        lo = (lo << 8) | uuid.data4[i];
+    return VoiceCallHandlerId(intern((quint64(uuid.data1) << 32) | (quint64(uuid.data2) << 16) | uuid.data3, lo));
+}
+
+VoiceCallHandlerId VoiceCallHandlerId::fromString(const QString &id)
+{
+    quint64 hi;
+    quint64 lo;
+    if (id.size() != 32 || !parse(id.constData(), &hi) || !parse(id.constData() + 16, &lo))
+        return VoiceCallHandlerId();
+    return VoiceCallHandlerId(intern(hi, lo));
+}
+
+const QString &VoiceCallHandlerId::toString() const
+{
+    static const QString null;
+    return d ? d->id : null;
+}
+
+const QString &VoiceCallHandlerId::objectPath() const
+{
+    static const QString null;
+    return d ? d->objectPath : null;
+}
+
+uint VoiceCallHandlerId::hash() const
+{
+    return d ? d->hash : 0;
+}
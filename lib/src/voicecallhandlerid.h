@@ -0,0 +1,72 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef VOICECALLHANDLERID_H
+#define VOICECALLHANDLERID_H
+
+#include <QString>
+
+struct VoiceCallHandlerIdData;
+
+/*
+  The identity of a call handler: 128 bits, shown as 32 lowercase hex
+  digits. Ids are interned while referenced, so that their string, the
+  D-Bus object path of the handler and the hash are built only once,
+  and comparing two ids compares pointers.
+
+  Thread-safe, as implicitly shared Qt types are.
+*/
+class VoiceCallHandlerId
+{
+public:
+    VoiceCallHandlerId() : d(0) {}
+    VoiceCallHandlerId(const VoiceCallHandlerId &other);
+    ~VoiceCallHandlerId();
+
+    VoiceCallHandlerId &operator=(const VoiceCallHandlerId &other);
+
+    static VoiceCallHandlerId generate();
+    // Null unless id is made of 32 hex digits.
+    static VoiceCallHandlerId fromString(const QString &id);
+
+    bool isNull() const { return !d; }
+
+    const QString &toString() const;
+    // The handler on the bus, "/calls/<id>".
+    const QString &objectPath() const;
+    uint hash() const;
+
+    bool operator==(const VoiceCallHandlerId &other) const { return d == other.d; }
+    bool operator!=(const VoiceCallHandlerId &other) const { return d != other.d; }
+
+private:
+    explicit VoiceCallHandlerId(VoiceCallHandlerIdData *data) : d(data) {}
+
+    static VoiceCallHandlerIdData *intern(quint64 hi, quint64 lo);
+
+    VoiceCallHandlerIdData *d;
+};
+
+inline uint qHash(const VoiceCallHandlerId &id, uint seed = 0)
+{
+    return id.hash() ^ seed;
+}
+
+#endif // VOICECALLHANDLERID_H
@@ -22,7 +22,13 @@
 #define VOICECALLMANAGERINTERFACE_H
 
 #include <QObject>
+#include <functional>
+#include <QVariantList>
+#include <QVariantMap>
 #include "abstractvoicecallprovider.h"
+#include "abstractvoicecallmanagerplugin.h"
+#include "voicecallchangeset.h"
+#include "voicecallhandlerid.h"
 
 class VoiceCallManagerInterface : public QObject
 {
@@ -55,15 +61,35 @@ public:
         TONE_RING
     } ToneType;
 
+    // A call as it was before the manager restarted.
+    struct ReclaimedVoiceCall {
+        QString handlerId;
+        QDateTime startedAt;
+        int duration = 0;
+        bool isIncoming = false;
+        bool isReclaimed = false;
+    };
+
     explicit VoiceCallManagerInterface(QObject *parent = 0) : QObject(parent) {/*...*/}
     virtual ~VoiceCallManagerInterface() {/*...*/}
 
     virtual QList<AbstractVoiceCallProvider*> providers() const = 0;
 
     virtual QString generateHandlerId() = 0;
+    // Providers identifying their calls by a path get the id a call
+    // had before a restart of the manager, or a new one. Paths may be
+    // reused, the line and start time of the call tell calls apart.
+    virtual ReclaimedVoiceCall reclaimVoiceCall(const QString &providerId, const QString &path,
+                                                const QString &lineId, const QDateTime &startedAt) = 0;
 
     virtual int voiceCallCount() const = 0;
     virtual QList<AbstractVoiceCallHandler*> voiceCalls() const = 0;
+    virtual AbstractVoiceCallHandler* voiceCall(const QString &handlerId) const = 0;
+    // The interned id of a live call or of one just generated. Null for
+    // other ids, those of the calls in a change set come with it.
+    virtual VoiceCallHandlerId voiceCallHandlerId(const QString &handlerId) const = 0;
+    virtual QList<AbstractVoiceCallHandler*> voiceCallsWithStatus(AbstractVoiceCallHandler::VoiceCallStatus status) const = 0;
+    virtual QList<AbstractVoiceCallHandler*> voiceCallsForProvider(const QString &providerId) const = 0;
 
     virtual AbstractVoiceCallHandler* activeVoiceCall() const = 0;
 
@@ -78,6 +104,17 @@ public:
     virtual int totalIncomingCallDuration() const = 0;
     virtual void resetCallDurationCounters() = 0;
 
+    // Runs task on behalf of plugin, right away or once calls are
+    // set up depending on the plugin priority.
+    virtual void schedule(AbstractVoiceCallManagerPlugin *plugin, const std::function<void ()> &task) = 0;
+
+    // Thread-safe: commands run in order on the thread of the manager,
+    // the way plugins living in their own thread call into it.
+    virtual void invoke(const std::function<void (VoiceCallManagerInterface *manager)> &command) = 0;
+
+    virtual QVariantMap lifecycleStatistics() const = 0;
+    virtual QVariantList lifecycleTimelines() const = 0;
+
 Q_SIGNALS:
     void error(const QString &errorString);
 
@@ -91,6 +128,10 @@ Q_SIGNALS:
 
     void activeVoiceCallChanged();
 
+    // Emitted once per event loop turn with everything that changed,
+    // voiceCallsChanged() and activeVoiceCallChanged() may be disabled.
+    void changeSetCommitted(const VoiceCallChangeSet &changes);
+
     void audioModeChanged();
     void audioRoutedChanged();
 
@@ -125,6 +166,9 @@ public Q_SLOTS:
 
     virtual void setCallFiltering(bool on = true) = 0;
 
+    virtual void traceVoiceCallEvent(const QString &handlerId, const QString &event) = 0;
+    virtual void resetLifecycleStatistics() = 0;
+
     virtual void playRingtone(const QString &ringtonePath) = 0;
     virtual void silenceRingtone() = 0;
 
@@ -0,0 +1,76 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef VOICECALLSNAPSHOT_H
+#define VOICECALLSNAPSHOT_H
+
+#include <QDateTime>
+#include <QMetaType>
+#include <QString>
+
+#include "abstractvoicecallhandler.h"
+#include "abstractvoicecallprovider.h"
+#include "voicecallhandlerid.h"
+
+/*
+  A call as it was when the snapshot was taken. Unlike the handler, a
+  snapshot can be handed over to plugins running in their own thread.
+*/
+struct VoiceCallSnapshot
+{
+    QString handlerId;
+    // Interned by the manager, null for calls with malformed ids.
+    VoiceCallHandlerId id;
+    QString providerId;
+    QString lineId;
+    QString subscriberId;
+    QString parentHandlerId;
+    QDateTime startedAt;
+    int duration = 0;
+    AbstractVoiceCallHandler::VoiceCallStatus status = AbstractVoiceCallHandler::STATUS_NULL;
+    bool isIncoming = false;
+    bool isEmergency = false;
+    bool isMultiparty = false;
+    bool isForwarded = false;
+    bool isRemoteHeld = false;
+
+    static VoiceCallSnapshot of(const AbstractVoiceCallHandler *handler)
+    {
+        VoiceCallSnapshot snapshot;
+        snapshot.handlerId = handler->handlerId();
+        snapshot.providerId = handler->provider()->providerId();
+        snapshot.lineId = handler->lineId();
+        snapshot.subscriberId = handler->subscriberId();
+        snapshot.parentHandlerId = handler->parentHandlerId();
+        snapshot.startedAt = handler->startedAt();
+        snapshot.duration = handler->duration();
+        snapshot.status = handler->status();
+        snapshot.isIncoming = handler->isIncoming();
+        snapshot.isEmergency = handler->isEmergency();
+        snapshot.isMultiparty = handler->isMultiparty();
+        snapshot.isForwarded = handler->isForwarded();
+        snapshot.isRemoteHeld = handler->isRemoteHeld();
+        return snapshot;
+    }
+};
+
+Q_DECLARE_METATYPE(VoiceCallSnapshot)
+
+#endif // VOICECALLSNAPSHOT_H
@@ -0,0 +1,296 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "voicecalltrace.h"
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct Record
+{
+    quint64 timestamp;
+    int site;
+    const void *object;
+};
+
+// Copies of the sites recorded so far, never freed.
+struct SiteCopy
+{
+    const char *function;
+    int line;
+};
+
+const int MaxSites = 8192;
+SiteCopy s_sites[MaxSites];
+std::atomic<int> s_siteCount(0);
+std::mutex s_sitesLock;
+
+int registerSite(const VoiceCallTrace::Site *site)
+{
+    std::lock_guard<std::mutex> locker(s_sitesLock);
+    int id = site->id.load(std::memory_order_acquire);
+    if (id < 0) {
+        id = s_siteCount.load(std::memory_order_relaxed);
+        if (id < MaxSites) {
+            s_sites[id].function = strdup(site->function);
+            s_sites[id].line = site->line;
+            s_siteCount.store(id + 1, std::memory_order_release);
+        }
+        site->id.store(id, std::memory_order_release);
+    }
+    return id;
+}
+
+struct Ring
+{
+    Record records[VoiceCallTrace::RingSize];
+    std::atomic<quint64> head;
+    std::atomic<bool> used;
+    quint32 tid;
+    Ring *next;
+};
+
+// Rings are never freed: the one of a finished thread is kept for
+// dumps until another thread takes it over.
+std::atomic<Ring *> s_rings(nullptr);
+
+struct Owner
+{
+    ~Owner()
+    {
+        if (ring) {
+            ring->used.store(false, std::memory_order_release);
+        }
+    }
+
+    Ring *ring = nullptr;
+};
+
+thread_local Owner t_owner;
+
+char s_crashPath[PATH_MAX];
+
+Ring *claim()
+{
+    const quint32 tid = syscall(SYS_gettid);
+    for (Ring *ring = s_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        bool used = false;
+        if (ring->used.compare_exchange_strong(used, true, std::memory_order_acq_rel)) {
+            ring->tid = tid;
+            ring->head.store(0, std::memory_order_release);
+            return ring;
+        }
+    }
+
+    Ring *ring = new Ring();
+    ring->used.store(true, std::memory_order_relaxed);
+    ring->tid = tid;
+    ring->next = s_rings.load(std::memory_order_relaxed);
+    while (!s_rings.compare_exchange_weak(ring->next, ring, std::memory_order_acq_rel)) {
+    }
+    return ring;
+}
+
+quint64 now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/*
+  Buffers the dump on the stack, so writing to a file descriptor only
+  involves write(2) and stays usable from a signal handler.
+*/
+class Writer
+{
+public:
+    typedef bool (*Sink)(void *context, const char *data, size_t size);
+
+    Writer(Sink sink, void *context)
+        : m_sink(sink), m_context(context)
+    {
+    }
+
+    template <typename T> void append(T value)
+    {
+        append(&value, sizeof(value));
+    }
+
+    void append(const void *data, size_t size)
+    {
+        if (m_size + size > sizeof(m_buffer)) {
+            flush();
+        }
+        if (size > sizeof(m_buffer)) {
+            m_ok = m_ok && m_sink(m_context, static_cast<const char *>(data), size);
+        } else {
+            memcpy(m_buffer + m_size, data, size);
+            m_size += size;
+        }
+    }
+
+    bool flush()
+    {
+        if (m_size) {
+            m_ok = m_ok && m_sink(m_context, m_buffer, m_size);
+            m_size = 0;
+        }
+        return m_ok;
+    }
+
+private:
+    Sink m_sink;
+    void *m_context;
+    char m_buffer[4096];
+    size_t m_size = 0;
+    bool m_ok = true;
+};
+
+bool writeDump(Writer &writer)
+{
+    writer.append("VCTR", 4);
+    writer.append(quint32(1));
+    writer.append(now());
+    writer.append(quint32(getpid()));
+
+    const int sites = s_siteCount.load(std::memory_order_acquire);
+    for (Ring *ring = s_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        const quint64 head = ring->head.load(std::memory_order_acquire);
+        if (!head) {
+            continue;
+        }
+        // The oldest slot of a full ring may be rewritten meanwhile.
+        const quint64 first = head > VoiceCallTrace::RingSize ? head - VoiceCallTrace::RingSize + 1 : 0;
+        writer.append(ring->tid);
+        writer.append(quint32(head - first));
+        for (quint64 i = first; i < head; i++) {
+            const Record record = ring->records[i & (VoiceCallTrace::RingSize - 1)];
+            const bool known = record.site >= 0 && record.site < sites;
+            const char *function = known && s_sites[record.site].function ? s_sites[record.site].function : "";
+            const quint32 length = strlen(function);
+            writer.append(record.timestamp);
+            writer.append(quint64(quintptr(record.object)));
+            writer.append(quint32(known ? s_sites[record.site].line : 0));
+            writer.append(length);
+            writer.append(function, length);
+        }
+    }
+    return writer.flush();
+}
+
+bool toFile(void *context, const char *data, size_t size)
+{
+    const int fd = *static_cast<int *>(context);
+    while (size) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool toByteArray(void *context, const char *data, size_t size)
+{
+    static_cast<QByteArray *>(context)->append(data, size);
+    return true;
+}
+
+void crashed(int signal)
+{
+    const int saved = errno;
+    const int fd = open(s_crashPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        VoiceCallTrace::dump(fd);
+        close(fd);
+    }
+    errno = saved;
+    // The default action was restored by SA_RESETHAND.
+    raise(signal);
+}
+
+}
+
+void VoiceCallTrace::record(const Site *site, const void *object)
+{
+    Ring *ring = t_owner.ring;
+    if (Q_UNLIKELY(!ring)) {
+        ring = t_owner.ring = claim();
+    }
+    const quint64 head = ring->head.load(std::memory_order_relaxed);
+    Record &record = ring->records[head & (RingSize - 1)];
+    int id = site->id.load(std::memory_order_acquire);
+    if (Q_UNLIKELY(id < 0)) {
+        id = registerSite(site);
+    }
+    record.timestamp = now();
+    record.site = id;
+    record.object = object;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+QByteArray VoiceCallTrace::dump()
+{
+    QByteArray result;
+    Writer writer(toByteArray, &result);
+    writeDump(writer);
+    return result;
+}
+
+bool VoiceCallTrace::dump(int fd)
+{
+    Writer writer(toFile, &fd);
+    return writeDump(writer);
+}
+
+void VoiceCallTrace::installCrashHandler(const QByteArray &path)
+{
+    if (path.isEmpty() || size_t(path.size()) >= sizeof(s_crashPath)) {
+        return;
+    }
+    memcpy(s_crashPath, path.constData(), path.size() + 1);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = crashed;
+    action.sa_flags = SA_RESETHAND | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    for (int signal : {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT}) {
+        sigaction(signal, &action, nullptr);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is a part of the Voice Call Manager Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef VOICECALLTRACE_H
+#define VOICECALLTRACE_H
+
+#include <QByteArray>
+
+#include <atomic>
+
+/*
+  Binary trace points, see TRACE in common.h.
+
+  Each thread records into its own ring of the last RingSize trace
+  points without locking nor formatting. A dump is laid out in host
+  byte order as:
+
+    header:  char magic[4] = "VCTR", quint32 version = 1,
+             quint64 monotonic time of the dump in ns, quint32 pid
+    thread:  quint32 tid, quint32 record count, followed by the records
+             of the thread, oldest first
+    record:  quint64 monotonic time in ns, quint64 object address,
+             quint32 line, quint32 function name length, function name
+
+  Threads follow each other until the end of the dump. The
+  voicecall-trace tool prints dumps as text.
+*/
+namespace VoiceCallTrace
+{
+    enum { RingSize = 1024 };
+
+    struct Site
+    {
+        const char *function;
+        int line;
+        mutable std::atomic<int> id; // Set on first record, initialize to -1.
+    };
+
+    // Sites are static, their name is copied on first use so that
+    // dumps do not depend on the plugin they come from being loaded.
+    void record(const Site *site, const void *object);
+
+    QByteArray dump();
+
+    // Async-signal-safe.
+    bool dump(int fd);
+
+    // Writes a dump to path when the process crashes.
+    void installCrashHandler(const QByteArray &path);
+}
+
+#endif // VOICECALLTRACE_H
@@ -23,71 +23,99 @@
 
 #include <common.h>
 #include <voicecallmanagerinterface.h>
-#include <abstractvoicecallhandler.h>
 
 #include <CommHistory/EventModel>
 #include <CommHistory/Event>
 
+#include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 class CommHistoryPlugin::Private
 {
 public:
-    Private()
+    Private(CommHistoryPlugin *plugin)
+        : m_plugin(plugin)
     {
         m_timer.setInterval(5 * 60000);
         connect(&m_timer, &QTimer::timeout,
                 [this] () {
                     for (const QString &id : m_calls.keys()) {
-                        CommHistory::Event &event = m_calls[id];
-                        storeCall(&event);
+                        store(id);
                     }
                 });
     }
 
+    CommHistoryPlugin *m_plugin;
     VoiceCallManagerInterface *m_manager = nullptr;
     QMap<QString, CommHistory::Event> m_calls;
+    QMap<QString, CommHistory::Event> m_ended;
+    QHash<QString, AbstractVoiceCallHandler::VoiceCallStatus> m_statuses;
+    QSet<QString> m_answered;
     QTimer m_timer;
     CommHistory::EventModel m_eventModel;
 
-    void newVoiceCall(const AbstractVoiceCallHandler &handler)
+    void newVoiceCall(const VoiceCallSnapshot &call)
     {
         CommHistory::Event event;
         event.setType(CommHistory::Event::CallEvent);
-        event.setLocalUid(handler.provider()->providerId());
+        event.setLocalUid(call.providerId);
         event.setRecipients(CommHistory::Recipient(event.localUid(),
-                                                   handler.lineId()));
-        event.setSubscriberIdentity(handler.subscriberId());
+                                                   call.lineId));
+        event.setSubscriberIdentity(call.subscriberId);
         event.setStartTime(QDateTime::currentDateTime());
         event.setEndTime(event.startTime());
-        event.setIsEmergencyCall(handler.isEmergency());
-        event.setDirection(handler.isIncoming() ? CommHistory::Event::Inbound
-                                                : CommHistory::Event::Outbound);
+        event.setIsEmergencyCall(call.isEmergency);
+        event.setDirection(call.isIncoming ? CommHistory::Event::Inbound
+                                           : CommHistory::Event::Outbound);
         // Don't store inbound events, since their incoming status
         // will only be known later (libcommhistory expects missed
         // calls to be known on event addition for instance).
+        if (m_calls.isEmpty()) {
+            m_timer.start();
+        }
+        m_calls.insert(call.handlerId, event);
+        // The status the call is added with is applied as any other.
+        m_statuses.insert(call.handlerId, AbstractVoiceCallHandler::STATUS_NULL);
         if (event.direction() == CommHistory::Event::Outbound) {
-            storeCall(&event);
+            store(call.handlerId);
         }
+    }
 
-        if (m_calls.isEmpty()) {
-            m_timer.start();
+    /*
+      Goes through the statuses a call had during the turn of the
+      change set, a call may be filtered as it is added, or answered
+      and hung up within a turn.
+    */
+    void onVoiceCallStatusesChanged(const VoiceCallChangeSet &changes, const QString &id)
+    {
+        const VoiceCallSnapshot call = changes.snapshots.value(id);
+        foreach (AbstractVoiceCallHandler::VoiceCallStatus status, changes.statuses.value(id)) {
+            onVoiceCallStatusChanged(call, status);
         }
-        m_calls.insert(handler.handlerId(), event);
+        onVoiceCallStatusChanged(call, call.status);
     }
 
-    void onVoiceCallStatusChanged(const AbstractVoiceCallHandler &handler)
+    void onVoiceCallStatusChanged(const VoiceCallSnapshot &call,
+                                  AbstractVoiceCallHandler::VoiceCallStatus status)
     {
-        CommHistory::Event &event = m_calls[handler.handlerId()];
+        AbstractVoiceCallHandler::VoiceCallStatus &known = m_statuses[call.handlerId];
+        if (known == status) {
+            return;
+        }
+        known = status;
 
-        switch (handler.status()) {
+        CommHistory::Event &event = m_calls[call.handlerId];
+
+        switch (status) {
         case AbstractVoiceCallHandler::STATUS_ACTIVE:
             event.setStartTime(QDateTime::currentDateTime());
             event.setEndTime(event.startTime());
-            storeCall(&event);
+            m_answered.insert(call.handlerId);
+            store(call.handlerId);
             break;
         case AbstractVoiceCallHandler::STATUS_DISCONNECTED:
-            event.setEndTime(event.startTime().addSecs(handler.duration()));
+            event.setEndTime(event.startTime().addSecs(call.duration));
             // No need to save the changes now, the voiceCallEnded will do it.
             break;
         case AbstractVoiceCallHandler::STATUS_IGNORED:
@@ -101,17 +129,53 @@ public:
         }
     }
 
-    void onVoiceCallEmergencyChanged(const AbstractVoiceCallHandler &handler)
+    void onVoiceCallEmergencyChanged(const VoiceCallSnapshot &call)
+    {
+        CommHistory::Event &event = m_calls[call.handlerId];
+        event.setIsEmergencyCall(call.isEmergency);
+        store(call.handlerId);
+    }
+
+    void onVoiceCallDurationChanged(const VoiceCallSnapshot &call)
+    {
+        CommHistory::Event &event = m_calls[call.handlerId];
+        event.setEndTime(event.startTime().addSecs(call.duration));
+    }
+
+    /*
+      Writing to the database is left for when calls are set up, the
+      event is then stored as it is by that time, the call may have
+      ended meanwhile.
+    */
+    void store(const QString &id)
     {
-        CommHistory::Event &event = m_calls[handler.handlerId()];
-        event.setIsEmergencyCall(handler.isEmergency());
-        storeCall(&event);
+        schedule([this, id] () {
+            QMap<QString, CommHistory::Event>::iterator it = m_calls.find(id);
+            if (it != m_calls.end()) {
+                storeCall(&it.value());
+            } else if ((it = m_ended.find(id)) != m_ended.end()) {
+                storeCall(&it.value());
+            }
+        });
     }
 
-    void onVoiceCallDurationChanged(const AbstractVoiceCallHandler &handler)
+    /*
+      The manager is only called from its own thread, the task is
+      posted back to the thread of the plugin once the manager lets
+      it run.
+    */
+    void schedule(const std::function<void ()> &task)
     {
-        CommHistory::Event &event = m_calls[handler.handlerId()];
-        event.setEndTime(event.startTime().addSecs(handler.duration()));
+        QPointer<CommHistoryPlugin> plugin(m_plugin);
+        m_manager->invoke([plugin, task] (VoiceCallManagerInterface *manager) {
+            if (plugin) {
+                manager->schedule(plugin, [plugin, task] () {
+                    if (plugin) {
+                        QMetaObject::invokeMethod(plugin.data(), task, Qt::QueuedConnection);
+                    }
+                });
+            }
+        });
     }
 
     void storeCall(CommHistory::Event *event)
@@ -127,15 +191,27 @@ public:
     void voiceCallEnded(const QString &id)
     {
         CommHistory::Event event = m_calls.take(id);
+        m_statuses.remove(id);
+        // The event of a call answered within the turn it ended in
+        // may not be stored yet.
+        const bool answered = m_answered.remove(id);
 
         if (event.direction() == CommHistory::Event::Inbound
             && event.incomingStatus() == CommHistory::Event::Received
-            && !event.isValid()) {
+            && !answered && !event.isValid()) {
             event.setIncomingStatus(CommHistory::Event::NotAnswered);
             event.setStartTime(QDateTime::currentDateTime());
             event.setEndTime(event.startTime());
         }
-        storeCall(&event);
+        // Kept until stored, along with the tasks scheduled before.
+        m_ended.insert(id, event);
+        schedule([this, id] () {
+            QMap<QString, CommHistory::Event>::iterator it = m_ended.find(id);
+            if (it != m_ended.end()) {
+                storeCall(&it.value());
+                m_ended.erase(it);
+            }
+        });
         if (m_calls.isEmpty()) {
             m_timer.stop();
         }
@@ -143,7 +219,7 @@ public:
 };
 
 CommHistoryPlugin::CommHistoryPlugin(QObject *parent)
-    : AbstractVoiceCallManagerPlugin(parent), d(new Private)
+    : AbstractVoiceCallManagerPlugin(parent)
 {
 }
 
@@ -156,8 +232,16 @@ QString CommHistoryPlugin::pluginId() const
     return PLUGIN_NAME;
 }
 
+AbstractVoiceCallManagerPlugin::Priority CommHistoryPlugin::priority() const
+{
+    return PRIORITY_DEFERRED;
+}
+
 bool CommHistoryPlugin::initialize()
 {
+    // Created here to live in the thread of the plugin, with its
+    // timer and event model.
+    d.reset(new Private(this));
     return true;
 }
 
@@ -175,19 +259,15 @@ bool CommHistoryPlugin::start()
 
 bool CommHistoryPlugin::suspend()
 {
-    disconnect(d->m_manager, &VoiceCallManagerInterface::voiceCallRemoved,
-               this, &CommHistoryPlugin::onVoiceCallRemoved);
-    disconnect(d->m_manager, &VoiceCallManagerInterface::voiceCallAdded,
-               this, &CommHistoryPlugin::onVoiceCallAdded);
+    disconnect(d->m_manager, &VoiceCallManagerInterface::changeSetCommitted,
+               this, &CommHistoryPlugin::onChangeSetCommitted);
     return true;
 }
 
 bool CommHistoryPlugin::resume()
 {
-    connect(d->m_manager, &VoiceCallManagerInterface::voiceCallAdded,
-            this, &CommHistoryPlugin::onVoiceCallAdded);
-    connect(d->m_manager, &VoiceCallManagerInterface::voiceCallRemoved,
-            this, &CommHistoryPlugin::onVoiceCallRemoved);
+    connect(d->m_manager, &VoiceCallManagerInterface::changeSetCommitted,
+            this, &CommHistoryPlugin::onChangeSetCommitted);
     return true;
 }
 
@@ -196,29 +276,43 @@ void CommHistoryPlugin::finalize()
     suspend();
 }
 
-void CommHistoryPlugin::onVoiceCallAdded(AbstractVoiceCallHandler *handler)
+/*
+  The plugin runs in a thread of its own, it only knows of the calls
+  through the snapshots of the change sets.
+*/
+void CommHistoryPlugin::onChangeSetCommitted(const VoiceCallChangeSet &changes)
 {
-    if (!handler) {
-        return;
+    foreach (const QString &id, changes.added) {
+        d->newVoiceCall(changes.snapshots.value(id));
+        d->onVoiceCallStatusesChanged(changes, id);
     }
 
-    connect(handler, &AbstractVoiceCallHandler::emergencyChanged,
-            this, [this, handler] (bool) {
-                d->onVoiceCallEmergencyChanged(*handler);
-            });
-    connect(handler, &AbstractVoiceCallHandler::statusChanged,
-            this, [this, handler] (AbstractVoiceCallHandler::VoiceCallStatus) {
-                d->onVoiceCallStatusChanged(*handler);
-            });
-    connect(handler, &AbstractVoiceCallHandler::durationChanged,
-            this, [this, handler] (bool) {
-                d->onVoiceCallDurationChanged(*handler);
-            });
-
-    d->newVoiceCall(*handler);
-}
+    for (QHash<QString, VoiceCallChangeSet::Properties>::const_iterator it = changes.changed.constBegin();
+         it != changes.changed.constEnd(); ++it) {
+        if (!d->m_calls.contains(it.key())) {
+            continue;
+        }
+        const VoiceCallSnapshot call = changes.snapshots.value(it.key());
+        // The statuses of added calls are already gone through.
+        if ((it.value() & VoiceCallChangeSet::PROPERTY_STATUS)
+            && !changes.added.contains(it.key())) {
+            d->onVoiceCallStatusesChanged(changes, it.key());
+        }
+        if (it.value() & VoiceCallChangeSet::PROPERTY_DURATION) {
+            d->onVoiceCallDurationChanged(call);
+        }
+        if (it.value() & VoiceCallChangeSet::PROPERTY_EMERGENCY) {
+            d->onVoiceCallEmergencyChanged(call);
+        }
+    }
 
-void CommHistoryPlugin::onVoiceCallRemoved(const QString &handlerId)
-{
-    d->voiceCallEnded(handlerId);
+    // A call may end within the turn it is removed, or even added.
+    foreach (const QString &id, changes.removed) {
+        if (d->m_calls.contains(id)) {
+            if (!changes.added.contains(id)) {
+                d->onVoiceCallStatusesChanged(changes, id);
+            }
+            d->voiceCallEnded(id);
+        }
+    }
 }
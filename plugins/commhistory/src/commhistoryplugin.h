@@ -24,14 +24,13 @@
 #include <QSharedPointer>
 
 #include <abstractvoicecallmanagerplugin.h>
-
-class AbstractVoiceCallHandler;
+#include <voicecallchangeset.h>
 
 class CommHistoryPlugin : public AbstractVoiceCallManagerPlugin
 {
     Q_OBJECT
 
-    Q_PLUGIN_METADATA(IID "org.nemomobile.voicecall.commhistory")
+    Q_PLUGIN_METADATA(IID "org.nemomobile.voicecall.commhistory" FILE "commhistoryplugin.json")
     Q_INTERFACES(AbstractVoiceCallManagerPlugin)
 
 public:
@@ -39,6 +38,7 @@ public:
     ~CommHistoryPlugin();
 
     QString pluginId() const;
+    Priority priority() const;
 
 public Q_SLOTS:
     bool initialize();
@@ -49,8 +49,7 @@ public Q_SLOTS:
     void finalize();
 
 private Q_SLOTS:
-    void onVoiceCallAdded(AbstractVoiceCallHandler *handler);
-    void onVoiceCallRemoved(const QString &handlerId);
+    void onChangeSetCommitted(const VoiceCallChangeSet &changes);
 
 private:
     class Private;
@@ -10,3 +10,6 @@ HEADERS += \
 
 SOURCES += \
     commhistoryplugin.cpp
+
+OTHER_FILES += \
+    commhistoryplugin.json
@@ -0,0 +1,226 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef STUBS_H
+#define STUBS_H
+
+#include <voicecallmanagerinterface.h>
+
+/*
+  A manager without calls, the plugin is only fed change sets. Tasks
+  and commands run right away, in the thread of the test.
+*/
+class Manager: public VoiceCallManagerInterface
+{
+    Q_OBJECT
+public:
+    Manager(QObject *parent = nullptr)
+        : VoiceCallManagerInterface(parent)
+    {
+    }
+
+    QList<AbstractVoiceCallProvider*> providers() const override
+    {
+        return QList<AbstractVoiceCallProvider*>();
+    }
+    QString generateHandlerId() override
+    {
+        return QString();
+    }
+    ReclaimedVoiceCall reclaimVoiceCall(const QString &providerId, const QString &path,
+                                        const QString &lineId, const QDateTime &startedAt) override
+    {
+        Q_UNUSED(providerId);
+        Q_UNUSED(path);
+        Q_UNUSED(lineId);
+        Q_UNUSED(startedAt);
+        return ReclaimedVoiceCall();
+    }
+    int voiceCallCount() const override
+    {
+        return 0;
+    }
+    QList<AbstractVoiceCallHandler*> voiceCalls() const override
+    {
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    AbstractVoiceCallHandler* voiceCall(const QString &handlerId) const override
+    {
+        Q_UNUSED(handlerId);
+        return nullptr;
+    }
+    VoiceCallHandlerId voiceCallHandlerId(const QString &handlerId) const override
+    {
+        Q_UNUSED(handlerId);
+        return VoiceCallHandlerId();
+    }
+    QList<AbstractVoiceCallHandler*> voiceCallsWithStatus(AbstractVoiceCallHandler::VoiceCallStatus status) const override
+    {
+        Q_UNUSED(status);
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    QList<AbstractVoiceCallHandler*> voiceCallsForProvider(const QString &providerId) const override
+    {
+        Q_UNUSED(providerId);
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    AbstractVoiceCallHandler* activeVoiceCall() const override
+    {
+        return nullptr;
+    }
+    QString audioMode() const override
+    {
+        return QString();
+    }
+    bool isAudioRouted() const override
+    {
+        return false;
+    }
+    bool isMicrophoneMuted() const override
+    {
+        return false;
+    }
+    bool isSpeakerMuted() const override
+    {
+        return false;
+    }
+    QString errorString() const override
+    {
+        return QString();
+    }
+    int totalOutgoingCallDuration() const override
+    {
+        return 0;
+    }
+    int totalIncomingCallDuration() const override
+    {
+        return 0;
+    }
+    void resetCallDurationCounters() override
+    {
+    }
+    void schedule(AbstractVoiceCallManagerPlugin *plugin, const std::function<void ()> &task) override
+    {
+        Q_UNUSED(plugin);
+        task();
+    }
+    void invoke(const std::function<void (VoiceCallManagerInterface *manager)> &command) override
+    {
+        command(this);
+    }
+    QVariantMap lifecycleStatistics() const override
+    {
+        return QVariantMap();
+    }
+    QVariantList lifecycleTimelines() const override
+    {
+        return QVariantList();
+    }
+
+public Q_SLOTS:
+    void setError(const QString &errorString) override
+    {
+        Q_UNUSED(errorString);
+    }
+    void appendProvider(AbstractVoiceCallProvider *provider) override
+    {
+        Q_UNUSED(provider);
+    }
+    void removeProvider(AbstractVoiceCallProvider *provider) override
+    {
+        Q_UNUSED(provider);
+    }
+    bool dial(const QString &providerId, const QString &msisdn) override
+    {
+        Q_UNUSED(providerId);
+        Q_UNUSED(msisdn);
+        return false;
+    }
+    void setCallFiltering(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void traceVoiceCallEvent(const QString &handlerId, const QString &event) override
+    {
+        Q_UNUSED(handlerId);
+        Q_UNUSED(event);
+    }
+    void resetLifecycleStatistics() override
+    {
+    }
+    void playRingtone(const QString &ringtonePath) override
+    {
+        Q_UNUSED(ringtonePath);
+    }
+    void silenceRingtone() override
+    {
+    }
+    void setAudioMode(const QString &mode) override
+    {
+        Q_UNUSED(mode);
+    }
+    void setAudioRouted(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void setMuteMicrophone(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void setMuteSpeaker(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void onAudioModeChanged(const QString &mode) override
+    {
+        Q_UNUSED(mode);
+    }
+    void onAudioRoutedChanged(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void onMuteMicrophoneChanged(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void onMuteSpeakerChanged(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void startEventTone(ToneType type, int volume) override
+    {
+        Q_UNUSED(type);
+        Q_UNUSED(volume);
+    }
+    void stopEventTone() override
+    {
+    }
+    void startDtmfTone(const QString &tone, int volume) override
+    {
+        Q_UNUSED(tone);
+        Q_UNUSED(volume);
+    }
+    void stopDtmfTone() override
+    {
+    }
+};
+
+#endif // STUBS_H
@@ -0,0 +1,28 @@
+include(../../plugin.pri)
+
+TEMPLATE = app
+QT += testlib
+
+PKGCONFIG += commhistory-qt5
+
+TARGET = tst_commhistory
+
+DEFINES += PLUGIN_NAME=\\\"commhistory-plugin\\\"
+
+SRCDIR = $$PWD/../src
+INCLUDEPATH += $$SRCDIR
+DEPENDPATH = $$INCLUDEPATH
+
+HEADERS += $$SRCDIR/commhistoryplugin.h \
+    stubs.h
+
+SOURCES += $$SRCDIR/commhistoryplugin.cpp \
+    tst_commhistory.cpp
+
+target.path = /opt/tests/voicecall/commhistory
+
+tests_xml.path = /opt/tests/voicecall/commhistory
+tests_xml.files = tests.xml
+INSTALLS += tests_xml
+
+OTHER_FILES += tests.xml
@@ -0,0 +1,212 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QTemporaryDir>
+
+#include <CommHistory/CallModel>
+#include <CommHistory/Event>
+
+#include <commhistoryplugin.h>
+
+#include "stubs.h"
+
+typedef AbstractVoiceCallHandler::VoiceCallStatus Status;
+typedef QVector<Status> Statuses;
+
+class tst_commhistory: public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_commhistory(QObject *parent = nullptr);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void tst_filteredOnAddition_data();
+    void tst_filteredOnAddition();
+    void tst_answeredWithinTurn();
+    void tst_missed();
+    void tst_addedAndRemovedWithinTurn();
+
+private:
+    VoiceCallSnapshot snapshot(const QString &number, Status status, int duration = 0) const;
+    void commitAdded(const VoiceCallSnapshot &call, const Statuses &statuses);
+    void commitRemoved(const VoiceCallSnapshot &call, const Statuses &statuses);
+    CommHistory::Event storedEvent(const QString &number) const;
+
+    QTemporaryDir mTmpHome;
+    Manager mManager;
+    CommHistoryPlugin mPlugin;
+};
+
+tst_commhistory::tst_commhistory(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void tst_commhistory::initTestCase()
+{
+    // This is used not to damage the user call history.
+    QVERIFY(mTmpHome.isValid());
+    qputenv("HOME", mTmpHome.path().toUtf8());
+    qputenv("XDG_DATA_HOME", mTmpHome.path().toUtf8());
+
+    QVERIFY(mPlugin.initialize());
+    QVERIFY(mPlugin.configure(&mManager));
+    QVERIFY(mPlugin.start());
+}
+
+void tst_commhistory::cleanupTestCase()
+{
+    mPlugin.finalize();
+}
+
+VoiceCallSnapshot tst_commhistory::snapshot(const QString &number, Status status, int duration) const
+{
+    VoiceCallSnapshot call;
+    call.handlerId = QStringLiteral("call-") + number;
+    call.providerId = QStringLiteral("/org/freedesktop/Telepathy/Account/ring/tel/ring");
+    call.lineId = number;
+    call.status = status;
+    call.duration = duration;
+    call.isIncoming = true;
+    return call;
+}
+
+void tst_commhistory::commitAdded(const VoiceCallSnapshot &call, const Statuses &statuses)
+{
+    VoiceCallChangeSet changes;
+    changes.added.append(call.handlerId);
+    changes.changed.insert(call.handlerId, VoiceCallChangeSet::PROPERTY_STATUS);
+    changes.snapshots.insert(call.handlerId, call);
+    changes.statuses.insert(call.handlerId, statuses);
+    emit mManager.changeSetCommitted(changes);
+}
+
+void tst_commhistory::commitRemoved(const VoiceCallSnapshot &call, const Statuses &statuses)
+{
+    VoiceCallChangeSet changes;
+    changes.removed.append(call.handlerId);
+    changes.snapshots.insert(call.handlerId, call);
+    changes.statuses.insert(call.handlerId, statuses);
+    emit mManager.changeSetCommitted(changes);
+}
+
+CommHistory::Event tst_commhistory::storedEvent(const QString &number) const
+{
+    CommHistory::CallModel model;
+    model.setQueryMode(CommHistory::EventModel::SyncQuery);
+    model.setFilter(CommHistory::CallModel::SortByTime);
+    model.getEvents();
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const CommHistory::Event event = model.event(model.index(row, 0));
+        if (event.remoteUid() == number) {
+            return event;
+        }
+    }
+    return CommHistory::Event();
+}
+
+void tst_commhistory::tst_filteredOnAddition_data()
+{
+    QTest::addColumn<QString>("number");
+    QTest::addColumn<int>("status");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("ignored") << QStringLiteral("+3581000001")
+                             << int(AbstractVoiceCallHandler::STATUS_IGNORED)
+                             << int(CommHistory::Event::Ignored);
+    QTest::newRow("rejected") << QStringLiteral("+3581000002")
+                              << int(AbstractVoiceCallHandler::STATUS_REJECTED)
+                              << int(CommHistory::Event::Rejected);
+}
+
+void tst_commhistory::tst_filteredOnAddition()
+{
+    QFETCH(QString, number);
+    QFETCH(int, status);
+    QFETCH(int, expected);
+
+    // The verdict lands within the turn the call is added in.
+    const Status verdict = Status(status);
+    commitAdded(snapshot(number, verdict), Statuses() << verdict);
+    commitRemoved(snapshot(number, AbstractVoiceCallHandler::STATUS_DISCONNECTED),
+                  Statuses() << AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+
+    QTRY_VERIFY(storedEvent(number).isValid());
+    QCOMPARE(int(storedEvent(number).incomingStatus()), expected);
+}
+
+void tst_commhistory::tst_answeredWithinTurn()
+{
+    const QString number = QStringLiteral("+3581000003");
+
+    commitAdded(snapshot(number, AbstractVoiceCallHandler::STATUS_INCOMING),
+                Statuses() << AbstractVoiceCallHandler::STATUS_INCOMING);
+    // Answered, held and hung up before the next change set.
+    commitRemoved(snapshot(number, AbstractVoiceCallHandler::STATUS_DISCONNECTED, 3),
+                  Statuses() << AbstractVoiceCallHandler::STATUS_ACTIVE
+                             << AbstractVoiceCallHandler::STATUS_HELD
+                             << AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+
+    QTRY_VERIFY(storedEvent(number).isValid());
+    const CommHistory::Event event = storedEvent(number);
+    QCOMPARE(event.incomingStatus(), CommHistory::Event::Received);
+    QCOMPARE(event.startTime().secsTo(event.endTime()), qint64(3));
+}
+
+void tst_commhistory::tst_missed()
+{
+    const QString number = QStringLiteral("+3581000004");
+
+    commitAdded(snapshot(number, AbstractVoiceCallHandler::STATUS_INCOMING),
+                Statuses() << AbstractVoiceCallHandler::STATUS_INCOMING);
+    commitRemoved(snapshot(number, AbstractVoiceCallHandler::STATUS_DISCONNECTED),
+                  Statuses() << AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+
+    QTRY_VERIFY(storedEvent(number).isValid());
+    QCOMPARE(storedEvent(number).incomingStatus(), CommHistory::Event::NotAnswered);
+}
+
+void tst_commhistory::tst_addedAndRemovedWithinTurn()
+{
+    const QString number = QStringLiteral("+3581000005");
+
+    // Rang and gave up on before the first change set went out.
+    const VoiceCallSnapshot call = snapshot(number, AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    VoiceCallChangeSet changes;
+    changes.added.append(call.handlerId);
+    changes.removed.append(call.handlerId);
+    changes.snapshots.insert(call.handlerId, call);
+    changes.statuses.insert(call.handlerId, Statuses() << AbstractVoiceCallHandler::STATUS_INCOMING
+                                                       << AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    emit mManager.changeSetCommitted(changes);
+
+    QTRY_VERIFY(storedEvent(number).isValid());
+    QCOMPARE(storedEvent(number).incomingStatus(), CommHistory::Event::NotAnswered);
+}
+
+#include "tst_commhistory.moc"
+QTEST_MAIN(tst_commhistory)
@@ -2,6 +2,8 @@ TEMPLATE = lib
 CONFIG += plugin link_pkgconfig
 # just for common.h
 INCLUDEPATH += $$PWD/../../../lib/src
+# trace points are logged only, there is nothing to dump them
+DEFINES += VOICECALL_TRACE_RECORDS=0
 
 QT = core dbus qml multimedia
 
@@ -28,7 +30,8 @@ SOURCES += \
     voicecallmodel.cpp \
     voicecallprovidermodel.cpp \
     voicecallplugin.cpp \
-    ../../../lib/src/common.cpp
+    ../../../lib/src/common.cpp \
+    ../../../lib/src/voicecallhandlerid.cpp
 
 OTHER_FILES += qmldir
 
@@ -2,14 +2,19 @@
 #include "voicecallhandler.h"
 #include "voicecallmanager.h"
 #include "voicecallmodel.h"
+#include "voicecallhandlerid.h"
 
 #include <QTimer>
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDBusPendingReply>
 #include <QDBusReply>
 #include <QVariantMap>
 #include <QSharedPointer>
 
+static const char *VoiceCallService = "org.nemomobile.voicecall";
+static const char *VoiceCallInterface = "org.nemomobile.voicecall.VoiceCall";
+
 /*!
   \class VoiceCallHandler
   \brief This is the D-Bus proxy for communicating with the voice call manager
@@ -24,12 +29,13 @@ public:
     VoiceCallHandlerPrivate(VoiceCallHandler *q, const QString &pHandlerId)
         : q_ptr(q)
         , handlerId(pHandlerId)
-        , interface(NULL)
         , childCalls(0)
         , parentCall(0)
         , connected(false)
+        , hasProperties(false)
         , duration(0)
         , status(0)
+        , incoming(false)
         , emergency(false)
         , multiparty(false)
         , forwarded(false)
@@ -39,13 +45,15 @@ public:
     VoiceCallHandler *q_ptr;
 
     QString handlerId;
+    VoiceCallHandlerId id;
 
-    QDBusInterface *interface;
+    QString path;
 
     VoiceCallModel *childCalls;
     QSharedPointer<VoiceCallHandler> parentCall;
 
     bool connected;
+    bool hasProperties;
     int duration;
     int status;
     QString statusText;
@@ -53,10 +61,23 @@ public:
     QString providerId;
     QString parentHandlerId;
     QDateTime startedAt;
+    QStringList childCallIds;
+    bool incoming;
     bool emergency;
     bool multiparty;
     bool forwarded;
     bool remoteHeld;
+
+    /*
+      Calls are made without a QDBusInterface, which would introspect
+      the call object synchronously when created.
+    */
+    QDBusPendingCall asyncCall(const QString &method, const QVariantList &arguments = QVariantList()) const
+    {
+        QDBusMessage message = QDBusMessage::createMethodCall(VoiceCallService, path, VoiceCallInterface, method);
+        message.setArguments(arguments);
+        return QDBusConnection::sessionBus().asyncCall(message);
+    }
 };
 
 /*!
@@ -67,12 +88,9 @@ VoiceCallHandler::VoiceCallHandler(const QString &handlerId, QObject *parent)
 {
     TRACE
     Q_D(VoiceCallHandler);
-    DEBUG_T("Creating D-Bus interface to: %s", qPrintable(handlerId));
-    d->interface = new QDBusInterface("org.nemomobile.voicecall",
-                                      "/calls/" + handlerId,
-                                      "org.nemomobile.voicecall.VoiceCall",
-                                      QDBusConnection::sessionBus(),
-                                      this);
+    DEBUG_T("Creating D-Bus proxy to: %s", qPrintable(handlerId));
+    d->id = VoiceCallHandlerId::fromString(handlerId);
+    d->path = d->id.isNull() ? "/calls/" + handlerId : d->id.objectPath();
 
     QTimer::singleShot(0, this, SLOT(initialize()));
 }
@@ -84,38 +102,35 @@ VoiceCallHandler::~VoiceCallHandler()
     delete d;
 }
 
-
-QDBusInterface* VoiceCallHandler::interface() const
-{
-    Q_D(const VoiceCallHandler);
-    return d->interface;
-}
-
 void VoiceCallHandler::initialize()
 {
     TRACE
     Q_D(VoiceCallHandler);
+    QDBusConnection bus = QDBusConnection::sessionBus();
     bool success = false;
 
-    if (d->interface->isValid()) {
+    if (bus.isConnected()) {
         success = true;
-        success &= (bool)QObject::connect(d->interface, SIGNAL(error(QString)), SIGNAL(error(QString)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(statusChanged(int,QString)), SLOT(onStatusChanged(int,QString)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(lineIdChanged(QString)), SLOT(onLineIdChanged(QString)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(durationChanged(int)), SLOT(onDurationChanged(int)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(startedAtChanged(QDateTime)), SLOT(onStartedAtChanged(QDateTime)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(emergencyChanged(bool)), SLOT(onEmergencyChanged(bool)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(multipartyChanged(bool)), SLOT(onMultipartyChanged(bool)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(forwardedChanged(bool)), SLOT(onForwardedChanged(bool)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(remoteHeldChanged(bool)), SLOT(onRemoteHeldChanged(bool)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(parentHandlerIdChanged(QString)), SLOT(onMultipartyHandlerIdChanged(QString)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(childCallsChanged(QStringList)), SLOT(onChildCallsChanged(QStringList)));
+        success &= bus.connect(VoiceCallService, d->path, VoiceCallInterface, "error",
+                               this, SIGNAL(error(QString)));
+        // All the changes of one event loop turn of the manager come at once.
+        success &= bus.connect(VoiceCallService, d->path,
+                               "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                               this, SLOT(onPropertiesChanged(QString,QVariantMap,QStringList)));
     }
 
     if (!(d->connected = success)) {
         QTimer::singleShot(2000, this, SLOT(initialize()));
-    } else {
-        QDBusPendingCall call = d->interface->asyncCall("getProperties");
+        return;
+    }
+
+    // Subscribing may have failed while the manager was not there.
+    if (receivers(SIGNAL(durationChanged())) > 0)
+        d->asyncCall("subscribeDuration", QVariantList() << 1000);
+
+    if (!d->hasProperties) {
+        // Calls published by the object manager come with their properties.
+        QDBusPendingCall call = d->asyncCall("getProperties");
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
         connect(watcher, &QDBusPendingCallWatcher::finished,
                 this, &VoiceCallHandler::onGetPropertiesFinished);
@@ -130,44 +145,86 @@ void VoiceCallHandler::onGetPropertiesFinished(QDBusPendingCallWatcher *watcher)
 
     if (reply.isError()) {
         qWarning() << "VoicecallHandler GetProperties D-Bus call failed" << reply.error().message();
-    } else {
-        QVariantMap props = reply.value();
-        d->providerId = props["providerId"].toString();
-        d->duration = props["duration"].toInt();
-        d->status = props["status"].toInt();
-        d->statusText = props["statusText"].toString();
-        d->lineId = props["lineId"].toString();
-        d->startedAt = QDateTime::fromMSecsSinceEpoch(props["startedAt"].toULongLong());
-        d->multiparty = props["isMultiparty"].toBool();
-        d->emergency = props["isEmergency"].toBool();
-        d->forwarded = props["isForwarded"].toBool();
-        d->remoteHeld = props["isRemoteHeld"].toBool();
-        d->parentHandlerId = props["parentHandlerId"].toString();
-
-        emit durationChanged();
-        emit statusChanged();
-        emit lineIdChanged();
-        emit startedAtChanged();
-        if (d->multiparty)
-            emit multipartyChanged();
-        if (d->emergency)
-            emit emergencyChanged();
-        if (d->forwarded)
-            emit forwardedChanged();
-        if (d->remoteHeld)
-            emit isRemoteHeld();
-        if (!d->parentHandlerId.isEmpty()) {
-            d->parentCall = VoiceCallManager::getCallHandler(d->parentHandlerId);
-            emit parentCallChanged();
-        }
-        if (d->multiparty) {
+    } else if (!d->hasProperties) {
+        setProperties(reply.value());
+    }
+}
+
+/*!
+  Takes the properties of the call as published by the manager, from
+  the object manager or getProperties().
+*/
+void VoiceCallHandler::setProperties(const QVariantMap &props)
+{
+    TRACE
+    Q_D(VoiceCallHandler);
+    d->hasProperties = true;
+    d->providerId = props["providerId"].toString();
+    d->incoming = props["isIncoming"].toBool();
+    d->duration = props["duration"].toInt();
+    d->status = props["status"].toInt();
+    d->statusText = props["statusText"].toString();
+    d->lineId = props["lineId"].toString();
+    d->startedAt = QDateTime::fromMSecsSinceEpoch(props["startedAt"].toULongLong());
+    d->multiparty = props["isMultiparty"].toBool();
+    d->emergency = props["isEmergency"].toBool();
+    d->forwarded = props["isForwarded"].toBool();
+    d->remoteHeld = props["isRemoteHeld"].toBool();
+    d->childCallIds = props["childCalls"].toStringList();
+
+    emit durationChanged();
+    emit statusChanged();
+    emit lineIdChanged();
+    emit startedAtChanged();
+    if (d->multiparty)
+        emit multipartyChanged();
+    if (d->emergency)
+        emit emergencyChanged();
+    if (d->forwarded)
+        emit forwardedChanged();
+    if (d->remoteHeld)
+        emit remoteHeldChanged();
+    onMultipartyHandlerIdChanged(props["parentHandlerId"].toString());
+    if (d->multiparty) {
+        if (!d->childCalls) {
             d->childCalls = new VoiceCallModel(this);
-            emit childCallsListChanged();
             emit childCallsChanged();
         }
+        emit childCallsListChanged();
     }
 }
 
+void VoiceCallHandler::onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                           const QStringList &invalidated)
+{
+    TRACE
+    Q_D(VoiceCallHandler);
+    Q_UNUSED(invalidated)
+    if (interface != QLatin1String(VoiceCallInterface))
+        return;
+
+    if (changed.contains("status"))
+        onStatusChanged(changed.value("status").toInt(), changed.value("statusText").toString());
+    if (changed.contains("lineId"))
+        onLineIdChanged(changed.value("lineId").toString());
+    if (changed.contains("startedAt"))
+        onStartedAtChanged(QDateTime::fromMSecsSinceEpoch(changed.value("startedAt").toLongLong()));
+    if (changed.contains("duration"))
+        onDurationChanged(changed.value("duration").toInt());
+    if (changed.contains("isEmergency"))
+        onEmergencyChanged(changed.value("isEmergency").toBool());
+    if (changed.contains("isMultiparty"))
+        onMultipartyChanged(changed.value("isMultiparty").toBool());
+    if (changed.contains("isForwarded"))
+        onForwardedChanged(changed.value("isForwarded").toBool());
+    if (changed.contains("isRemoteHeld"))
+        onRemoteHeldChanged(changed.value("isRemoteHeld").toBool());
+    if (changed.contains("parentHandlerId"))
+        onMultipartyHandlerIdChanged(changed.value("parentHandlerId").toString());
+    if (changed.contains("childCalls"))
+        onChildCallsChanged(changed.value("childCalls").toStringList());
+}
+
 void VoiceCallHandler::onDurationChanged(int duration)
 {
     Q_D(VoiceCallHandler);
@@ -247,11 +304,32 @@ void VoiceCallHandler::onMultipartyHandlerIdChanged(QString handlerId)
 
 void VoiceCallHandler::onChildCallsChanged(const QStringList &calls)
 {
-    Q_UNUSED(calls);
     TRACE
+    Q_D(VoiceCallHandler);
+    d->childCallIds = calls;
     emit childCallsListChanged();
 }
 
+/*
+  Durations are only sent by the manager to those subscribing, so the
+  subscription lasts as long as somebody follows durationChanged().
+*/
+void VoiceCallHandler::connectNotify(const QMetaMethod &signal)
+{
+    Q_D(VoiceCallHandler);
+    if (signal == QMetaMethod::fromSignal(&VoiceCallHandler::durationChanged)
+            && receivers(SIGNAL(durationChanged())) == 1)
+        d->asyncCall("subscribeDuration", QVariantList() << 1000);
+}
+
+void VoiceCallHandler::disconnectNotify(const QMetaMethod &signal)
+{
+    Q_D(VoiceCallHandler);
+    if (signal == QMetaMethod::fromSignal(&VoiceCallHandler::durationChanged)
+            && receivers(SIGNAL(durationChanged())) == 0)
+        d->asyncCall("unsubscribeDuration");
+}
+
 /*!
   Returns this voice calls' handler id.
  */
@@ -321,7 +399,7 @@ int VoiceCallHandler::duration() const
 bool VoiceCallHandler::isIncoming() const
 {
     Q_D(const VoiceCallHandler);
-    return d->interface->property("isIncoming").toBool();
+    return d->incoming;
 }
 
 /*!
@@ -357,6 +435,15 @@ VoiceCallModel* VoiceCallHandler::childCalls() const
     return d->childCalls;
 }
 
+/*!
+  Returns the handler ids of the calls of this conference.
+ */
+QStringList VoiceCallHandler::childCallIds() const
+{
+    Q_D(const VoiceCallHandler);
+    return d->childCallIds;
+}
+
 VoiceCallHandler* VoiceCallHandler::parentCall() const
 {
     Q_D(const VoiceCallHandler);
@@ -380,7 +467,7 @@ void VoiceCallHandler::answer()
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("answer");
+    QDBusPendingCall call = d->asyncCall("answer");
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -394,7 +481,7 @@ void VoiceCallHandler::hangup()
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("hangup");
+    QDBusPendingCall call = d->asyncCall("hangup");
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -408,7 +495,7 @@ void VoiceCallHandler::hold(bool on)
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("hold", on);
+    QDBusPendingCall call = d->asyncCall("hold", QVariantList() << on);
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -422,7 +509,7 @@ void VoiceCallHandler::deflect(const QString &target)
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("deflect", target);
+    QDBusPendingCall call = d->asyncCall("deflect", QVariantList() << target);
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -433,7 +520,7 @@ void VoiceCallHandler::sendDtmf(const QString &tones)
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("sendDtmf", tones);
+    QDBusPendingCall call = d->asyncCall("sendDtmf", QVariantList() << tones);
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -444,7 +531,7 @@ void VoiceCallHandler::merge(const QString &callHandle)
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall conf = d->interface->asyncCall("merge", callHandle);
+    QDBusPendingCall conf = d->asyncCall("merge", QVariantList() << callHandle);
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(conf, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -455,7 +542,7 @@ void VoiceCallHandler::split()
 {
     TRACE
     Q_D(VoiceCallHandler);
-    QDBusPendingCall call = d->interface->asyncCall("split");
+    QDBusPendingCall call = d->asyncCall("split");
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
@@ -3,8 +3,9 @@
 
 #include <QObject>
 #include <QDateTime>
+#include <QStringList>
+#include <QVariantMap>
 
-#include <QDBusInterface>
 #include <QDBusPendingCallWatcher>
 
 class VoiceCallModel;
@@ -45,8 +46,6 @@ public:
     explicit VoiceCallHandler(const QString &handlerId, QObject *parent = 0);
     ~VoiceCallHandler();
 
-    QDBusInterface* interface() const;
-
     QString handlerId() const;
     QString providerId() const;
     int status() const;
@@ -62,6 +61,10 @@ public:
     VoiceCallModel* childCalls() const;
     VoiceCallHandler* parentCall() const;
 
+    QStringList childCallIds() const;
+
+    void setProperties(const QVariantMap &properties);
+
 Q_SIGNALS:
     void error(const QString &error);
     void statusChanged();
@@ -85,11 +88,17 @@ public Q_SLOTS:
     void merge(const QString &callHandle);
     void split();
 
+protected:
+    void connectNotify(const QMetaMethod &signal);
+    void disconnectNotify(const QMetaMethod &signal);
+
 private Q_SLOTS:
     void initialize();
 
     void onPendingCallFinished(QDBusPendingCallWatcher *watcher);
     void onPendingVoidCallFinished(QDBusPendingCallWatcher *watcher);
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                             const QStringList &invalidated);
     void onDurationChanged(int duration);
     void onStatusChanged(int status, const QString &statusText);
     void onLineIdChanged(const QString &lineId);
@@ -1,5 +1,6 @@
 #include "common.h"
 #include "voicecallmanager.h"
+#include "voicecallhandlerid.h"
 
 #ifdef WITH_NGF
 #include <NgfClient>
@@ -9,10 +10,22 @@
 #include <QQmlEngine>
 #include <QTimer>
 #include <QDBusInterface>
+#include <QDBusMetaType>
 #include <QDBusPendingReply>
 #include <QSharedPointer>
 #include <QGlobalStatic>
 
+namespace {
+const QLatin1String ObjectManagerInterface("org.freedesktop.DBus.ObjectManager");
+const QLatin1String VoiceCallInterface("org.nemomobile.voicecall.VoiceCall");
+const QLatin1String CallsPath("/calls/");
+
+QString handlerIdOf(const QDBusObjectPath &path)
+{
+    return path.path().startsWith(CallsPath) ? path.path().mid(CallsPath.size()) : QString();
+}
+}
+
 class VoiceCallManagerPrivate
 {
     Q_DECLARE_PUBLIC(VoiceCallManager)
@@ -32,6 +45,21 @@ public:
     {
     }
 
+    // Seeds or updates the call at path, returns whether it is new.
+    bool updateVoiceCall(const QDBusObjectPath &path, const VoiceCallInterfaceList &interfaces)
+    {
+        const QString handlerId = handlerIdOf(path);
+        if (handlerId.isEmpty() || !interfaces.contains(VoiceCallInterface))
+            return false;
+
+        QSharedPointer<VoiceCallHandler> handler = VoiceCallManager::getCallHandler(handlerId);
+        handler->setProperties(interfaces.value(VoiceCallInterface));
+        if (calls.contains(handler))
+            return false;
+        calls.append(handler);
+        return true;
+    }
+
     VoiceCallManager *q_ptr;
     QDBusInterface *interface;
     VoiceCallModel *voicecalls;
@@ -45,6 +73,10 @@ public:
     quint32 eventId;
     bool connected;
     QString modemPath;
+
+    // The calls published by the object manager of the service, in
+    // the order they came.
+    QList<QSharedPointer<VoiceCallHandler> > calls;
 };
 
 VoiceCallManager::VoiceCallManager(QObject *parent)
@@ -52,6 +84,8 @@ VoiceCallManager::VoiceCallManager(QObject *parent)
 {
     TRACE
     Q_D(VoiceCallManager);
+    qDBusRegisterMetaType<VoiceCallInterfaceList>();
+    qDBusRegisterMetaType<VoiceCallManagedObjectList>();
     d->interface = new QDBusInterface("org.nemomobile.voicecall",
                                       "/",
                                       "org.nemomobile.voicecall.VoiceCallManager",
@@ -85,16 +119,26 @@ void VoiceCallManager::initialize()
     if (d->interface->isValid()) {
         success = true;
         success &= (bool)QObject::connect(d->interface, SIGNAL(error(QString)), SIGNAL(error(QString)));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(voiceCallsChanged()), SLOT(onVoiceCallsChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(providersChanged()), SLOT(onProvidersChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(activeVoiceCallChanged()), SLOT(onActiveVoiceCallChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(audioModeChanged()), SIGNAL(audioModeChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(audioRoutedChanged()), SIGNAL(audioRoutedChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(microphoneMutedChanged()), SIGNAL(microphoneMutedChanged()));
-        success &= (bool)QObject::connect(d->interface, SIGNAL(speakerMutedChanged()), SIGNAL(speakerMutedChanged()));
+        // All the changes of one event loop turn of the manager come at once.
+        success &= QDBusConnection::sessionBus().connect(d->interface->service(), d->interface->path(),
+                                                         "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                                         this, SLOT(onPropertiesChanged(QString,QVariantMap,QStringList)));
+        // Calls come and go along with their properties.
+        success &= QDBusConnection::sessionBus().connect(d->interface->service(), d->interface->path(),
+                                                         ObjectManagerInterface, "InterfacesAdded",
+                                                         this, SLOT(onInterfacesAdded(QDBusObjectPath,VoiceCallInterfaceList)));
+        success &= QDBusConnection::sessionBus().connect(d->interface->service(), d->interface->path(),
+                                                         ObjectManagerInterface, "InterfacesRemoved",
+                                                         this, SLOT(onInterfacesRemoved(QDBusObjectPath,QStringList)));
+    }
 
-        onActiveVoiceCallChanged();
-        onVoiceCallsChanged();
+    if (success) {
+        QDBusMessage message = QDBusMessage::createMethodCall(d->interface->service(), d->interface->path(),
+                                                              ObjectManagerInterface, "GetManagedObjects");
+        QDBusPendingCall call = QDBusConnection::sessionBus().asyncCall(message);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
+                         this, &VoiceCallManager::onGetManagedObjectsFinished);
     }
 
     if (!(d->connected = success)) {
@@ -120,6 +164,19 @@ VoiceCallProviderModel* VoiceCallManager::providers() const
     return d->providers;
 }
 
+/*!
+  Returns the handler ids of the calls of the manager, as last told by
+  its object manager.
+*/
+QStringList VoiceCallManager::voiceCallIds() const
+{
+    Q_D(const VoiceCallManager);
+    QStringList result;
+    foreach (const QSharedPointer<VoiceCallHandler> &handler, d->calls)
+        result.append(handler->handlerId());
+    return result;
+}
+
 QString VoiceCallManager::defaultProviderId() const
 {
     TRACE
@@ -331,6 +388,30 @@ bool VoiceCallManager::stopDtmfTone()
     return true;
 }
 
+void VoiceCallManager::onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                           const QStringList &invalidated)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    Q_UNUSED(invalidated)
+    if (interface != d->interface->interface())
+        return;
+
+    if (changed.contains("providers"))
+        onProvidersChanged();
+    // The calls themselves are followed through the object manager.
+    if (changed.contains("activeVoiceCall"))
+        onActiveVoiceCallChanged();
+    if (changed.contains("audioMode"))
+        emit audioModeChanged();
+    if (changed.contains("isAudioRouted"))
+        emit audioRoutedChanged();
+    if (changed.contains("isMicrophoneMuted"))
+        emit microphoneMutedChanged();
+    if (changed.contains("isSpeakerMuted"))
+        emit speakerMutedChanged();
+}
+
 void VoiceCallManager::onVoiceCallsChanged()
 {
     TRACE
@@ -358,6 +439,59 @@ void VoiceCallManager::onActiveVoiceCallChanged()
     emit this->activeVoiceCallChanged();
 }
 
+void VoiceCallManager::onInterfacesAdded(const QDBusObjectPath &path, const VoiceCallInterfaceList &interfaces)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    if (d->updateVoiceCall(path, interfaces))
+        onVoiceCallsChanged();
+}
+
+void VoiceCallManager::onInterfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    const QString handlerId = handlerIdOf(path);
+    if (handlerId.isEmpty() || !interfaces.contains(VoiceCallInterface))
+        return;
+
+    for (int i = 0; i < d->calls.count(); ++i) {
+        if (d->calls.at(i)->handlerId() == handlerId) {
+            d->calls.removeAt(i);
+            onVoiceCallsChanged();
+            break;
+        }
+    }
+}
+
+/*
+  The reply tells of every call as of when it was sent, the signals
+  received meanwhile are already part of it.
+*/
+void VoiceCallManager::onGetManagedObjectsFinished(QDBusPendingCallWatcher *watcher)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    QDBusPendingReply<VoiceCallManagedObjectList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError()) {
+        qWarning() << "VoiceCallManager GetManagedObjects D-Bus call failed" << reply.error().message();
+        return;
+    }
+
+    // Holds the known handlers meanwhile, not to make them anew.
+    const QList<QSharedPointer<VoiceCallHandler> > previous = d->calls;
+    d->calls.clear();
+    const VoiceCallManagedObjectList objects = reply.value();
+    for (VoiceCallManagedObjectList::const_iterator it = objects.constBegin(); it != objects.constEnd(); ++it)
+        d->updateVoiceCall(it.key(), it.value());
+
+    // Ahead of the active call, looked up among the calls.
+    onVoiceCallsChanged();
+    onActiveVoiceCallChanged();
+}
+
 void VoiceCallManager::onPendingBoolCallFinished(QDBusPendingCallWatcher *watcher)
 {
     TRACE
@@ -386,16 +520,21 @@ void VoiceCallManager::onPendingVoidCallFinished(QDBusPendingCallWatcher *watche
     watcher->deleteLater();
 }
 
-typedef QMap<QString, QWeakPointer<VoiceCallHandler>> VoiceCallHandlerMap;
+typedef QHash<VoiceCallHandlerId, QWeakPointer<VoiceCallHandler>> VoiceCallHandlerMap;
 Q_GLOBAL_STATIC(VoiceCallHandlerMap, callHandlers);
 
 QSharedPointer<VoiceCallHandler> VoiceCallManager::getCallHandler(const QString &handlerId)
 {
-    QSharedPointer<VoiceCallHandler> handler = callHandlers->value(handlerId);
+    // Ids not coming from the manager are not shared.
+    const VoiceCallHandlerId id = VoiceCallHandlerId::fromString(handlerId);
+    QSharedPointer<VoiceCallHandler> handler;
+    if (!id.isNull())
+        handler = callHandlers->value(id);
     if (handler.isNull()) {
         handler.reset(new VoiceCallHandler(handlerId), &QObject::deleteLater);
         QQmlEngine::setObjectOwnership(handler.data(), QQmlEngine::CppOwnership);
-        callHandlers->insert(handlerId, handler);
+        if (!id.isNull())
+            callHandlers->insert(id, handler);
     }
 
     // Cleanup any destroyed handlers
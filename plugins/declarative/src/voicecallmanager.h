@@ -9,8 +9,13 @@
 #include <QObject>
 
 #include <QDBusInterface>
+#include <QDBusObjectPath>
 #include <QDBusPendingCallWatcher>
 
+// a{sa{sv}} and a{oa{sa{sv}}}, as sent by the object manager of the service.
+typedef QMap<QString, QVariantMap> VoiceCallInterfaceList;
+typedef QMap<QDBusObjectPath, VoiceCallInterfaceList> VoiceCallManagedObjectList;
+
 class VoiceCallManager : public QObject
 {
     Q_OBJECT
@@ -36,6 +41,8 @@ public:
     VoiceCallModel* voiceCalls() const;
     VoiceCallProviderModel* providers() const;
 
+    QStringList voiceCallIds() const;
+
     QString defaultProviderId() const;
 
     VoiceCallHandler* activeVoiceCall() const;
@@ -87,10 +94,16 @@ public Q_SLOTS:
 protected Q_SLOTS:
     void initialize();
 
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                             const QStringList &invalidated);
     void onProvidersChanged();
     void onVoiceCallsChanged();
     void onActiveVoiceCallChanged();
 
+    void onInterfacesAdded(const QDBusObjectPath &path, const VoiceCallInterfaceList &interfaces);
+    void onInterfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces);
+    void onGetManagedObjectsFinished(QDBusPendingCallWatcher *watcher);
+
     void onPendingBoolCallFinished(QDBusPendingCallWatcher *watcher);
     void onPendingVoidCallFinished(QDBusPendingCallWatcher *watcher);
 
@@ -101,4 +114,7 @@ private:
     Q_DECLARE_PRIVATE(VoiceCallManager)
 };
 
+Q_DECLARE_METATYPE(VoiceCallInterfaceList)
+Q_DECLARE_METATYPE(VoiceCallManagedObjectList)
+
 #endif // VOICECALLMANAGER_H
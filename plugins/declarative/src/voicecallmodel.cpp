@@ -176,9 +176,9 @@ void VoiceCallModel::onVoiceCallsChanged()
     QStringList removed;
 
     if (d->manager)
-        nIds = d->manager->interface()->property("voiceCalls").toStringList();
+        nIds = d->manager->voiceCallIds();
     else
-        nIds = d->confHandler->interface()->property("childCalls").toStringList();
+        nIds = d->confHandler->childCallIds();
 
     // Map current call handlers to handler ids for easy indexing.
     foreach (QSharedPointer<VoiceCallHandler> handler, d->handlers) {
@@ -21,23 +21,135 @@
 
 #include "filter.h"
 #include "filterlist.h"
+#include "filterindex.h"
 
 #include <CommHistory/Recipient>
 
 #include <abstractvoicecallprovider.h>
 
+#include <MGConfItem>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+#include <atomic>
+
 using namespace VoiceCall;
 
+static const char *const Root = "/sailfish/voicecall/filter/";
+
 class Filter::Private
 {
 public:
-    Private()
-        : m_rejected(QString::fromLatin1("/sailfish/voicecall/filter/rejected-numbers"))
-        , m_ignored(QString::fromLatin1("/sailfish/voicecall/filter/ignored-numbers"))
-        , m_whitelist(QString::fromLatin1("/sailfish/voicecall/filter/whitelist"))
+    Private(const QString &providerId)
+        : m_global(QString::fromLatin1(Root))
+        , m_providerId(providerId)
+        , m_lists(providerId.isEmpty() ? &m_global : partition(providerId))
+        , m_latency(new Latency)
     {
     }
 
+    // The lists stored under one GConf directory.
+    struct Lists {
+        explicit Lists(const QString &root)
+            : rejected(root + QStringLiteral("rejected-numbers"))
+            , ignored(root + QStringLiteral("ignored-numbers"))
+            , whitelist(root + QStringLiteral("whitelist"))
+        {
+        }
+
+        FilterList rejected;
+        FilterList ignored;
+        FilterList whitelist;
+    };
+
+    // Provider ids are object paths, escape them into a key name
+    // the way D-Bus object paths escape arbitrary strings.
+    static QString partitionRoot(const QString &providerId)
+    {
+        QString root = QString::fromLatin1(Root) + QStringLiteral("providers/");
+        for (const char c : providerId.toUtf8()) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+                root.append(QLatin1Char(c));
+            } else {
+                root.append(QStringLiteral("_%1").arg(uchar(c), 2, 16, QLatin1Char('0')));
+            }
+        }
+        return root.append('/');
+    }
+
+    Lists *partition(const QString &providerId)
+    {
+        QSharedPointer<Lists> &lists = m_partitions[providerId];
+        if (!lists) {
+            lists.reset(new Lists(partitionRoot(providerId)));
+        }
+        return lists.data();
+    }
+
+    // Watches the keys and tables of a provider without rules, so that
+    // its calls probe them again only after one of them changed.
+    struct Probe {
+        explicit Probe(const QString &root)
+            : rejected(root + QStringLiteral("rejected-numbers"))
+            , ignored(root + QStringLiteral("ignored-numbers"))
+            , whitelist(root + QStringLiteral("whitelist"))
+        {
+            const QString tableDir = QFileInfo(FilterList::tableFile(rejected.key())).absolutePath();
+            if (QDir().mkpath(tableDir)) {
+                tableWatcher.addPath(tableDir);
+            }
+            for (MGConfItem *item : {&rejected, &ignored, &whitelist}) {
+                QObject::connect(item, &MGConfItem::valueChanged,
+                                 &tableWatcher, [this] () { stale = true; });
+            }
+            QObject::connect(&tableWatcher, &QFileSystemWatcher::directoryChanged,
+                             &tableWatcher, [this] () { stale = true; });
+        }
+
+        bool isConfigured()
+        {
+            if (stale) {
+                stale = false;
+                configured = false;
+                for (const MGConfItem *item : {&rejected, &ignored, &whitelist}) {
+                    configured = configured
+                        || !item->value().toStringList().isEmpty()
+                        || QFileInfo::exists(FilterList::tableFile(item->key()));
+                }
+            }
+            return configured;
+        }
+
+        MGConfItem rejected;
+        MGConfItem ignored;
+        MGConfItem whitelist;
+        QFileSystemWatcher tableWatcher;
+        bool stale = true;
+        bool configured = false;
+    };
+
+    // Providers without rules of their own are not given a partition,
+    // they are probed again once their keys or tables change instead.
+    Lists *configuredPartition(const QString &providerId)
+    {
+        QHash<QString, QSharedPointer<Lists>>::const_iterator it = m_partitions.constFind(providerId);
+        if (it != m_partitions.constEnd()) {
+            return it.value().data();
+        }
+        QSharedPointer<Probe> &probe = m_probes[providerId];
+        if (!probe) {
+            probe.reset(new Probe(partitionRoot(providerId)));
+        }
+        if (!probe->isConfigured()) {
+            return nullptr;
+        }
+        m_probes.remove(providerId);
+        return partition(providerId);
+    }
+
     enum Action {
         FILTER_NO_MATCH,
         FILTER_APPROVE,
@@ -45,40 +157,184 @@ public:
         FILTER_REJECT
     };
 
-    Action apply(const CommHistory::Recipient &recipient) const
-    {
-        // Give priority to exact matching.
-        if (m_whitelist.exactMatch(recipient.remoteUid())) {
-            return FILTER_APPROVE;
-        } else if (m_rejected.exactMatch(recipient.remoteUid())) {
-            return FILTER_REJECT;
-        } else if (m_ignored.exactMatch(recipient.remoteUid())) {
-            return FILTER_IGNORE;
-        } else if (m_whitelist.match(recipient)) {
-            return FILTER_APPROVE;
-        } else if (m_rejected.match(recipient)) {
-            return FILTER_REJECT;
-        } else if (m_ignored.match(recipient)) {
-            return FILTER_IGNORE;
-        } else {
+    // Evaluation times, bucket i counts the evaluations which took
+    // less than 2^i microseconds and more than half of it.
+    struct Latency {
+        enum { BucketCount = 24 };
+
+        Latency()
+        {
+            reset();
+        }
+
+        void record(qint64 nsecs)
+        {
+            quint64 usecs = nsecs / 1000;
+            int bucket = 0;
+            while (usecs && bucket < BucketCount - 1) {
+                usecs >>= 1;
+                bucket++;
+            }
+            buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            for (std::atomic<quint64> &bucket : buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<quint64> buckets[BucketCount];
+    };
+
+    // Compiled lists at a given time, they can be evaluated on any thread.
+    struct Indexes {
+        QSharedPointer<const FilterIndex> rejected;
+        QSharedPointer<const FilterIndex> ignored;
+        QSharedPointer<const FilterIndex> whitelist;
+
+        Action apply(const CommHistory::Recipient &recipient, bool record) const
+        {
+            const struct {
+                const FilterIndex *index;
+                Action action;
+            } lists[] = {
+                {whitelist.data(), FILTER_APPROVE},
+                {rejected.data(), FILTER_REJECT},
+                {ignored.data(), FILTER_IGNORE}
+            };
+            int rule = -1;
+
+            // Give priority to exact matching.
+            for (const auto &list : lists) {
+                if (list.index->exactMatch(recipient.remoteUid(), &rule)) {
+                    if (record) {
+                        list.index->hit(rule);
+                    }
+                    return list.action;
+                }
+            }
+            for (const auto &list : lists) {
+                if (list.index->match(recipient, &rule)) {
+                    if (record) {
+                        list.index->hit(rule);
+                    }
+                    return list.action;
+                }
+            }
             return FILTER_NO_MATCH;
         }
+    };
+
+    struct Snapshot {
+        Indexes partition; // Unset when the provider has no rules.
+        Indexes global;
+        QSharedPointer<Latency> latency;
+
+        Action apply(const CommHistory::Recipient &recipient, bool record = false) const
+        {
+            // Rules of the line come first, the global ones are a fallback.
+            if (partition.rejected) {
+                const Action action = partition.apply(recipient, record);
+                if (action != FILTER_NO_MATCH) {
+                    return action;
+                }
+            }
+            return global.apply(recipient, record);
+        }
+
+        // Applies the lists to an incoming call, accounting for it.
+        Action evaluate(const CommHistory::Recipient &recipient) const
+        {
+            QElapsedTimer timer;
+            timer.start();
+            const Action action = apply(recipient, true);
+            latency->record(timer.nsecsElapsed());
+            return action;
+        }
+    };
+
+    static Indexes indexes(const Lists &lists)
+    {
+        return Indexes{lists.rejected.snapshot(), lists.ignored.snapshot(),
+                       lists.whitelist.snapshot()};
+    }
+
+    Snapshot snapshot(const QString &providerId)
+    {
+        Snapshot snapshot;
+        snapshot.global = indexes(m_global);
+        snapshot.latency = m_latency;
+        const Lists *lists = providerId.isEmpty() ? nullptr : configuredPartition(providerId);
+        if (lists) {
+            const Indexes partition = indexes(*lists);
+            if (!partition.rejected->isEmpty()
+                || !partition.ignored->isEmpty()
+                || !partition.whitelist->isEmpty()) {
+                snapshot.partition = partition;
+            }
+        }
+        return snapshot;
+    }
+
+    // Whether the number is blocked by a list seen from this filter.
+    bool blocked(const CommHistory::Recipient &recipient) const
+    {
+        return m_lists->rejected.match(recipient)
+            || m_lists->ignored.match(recipient)
+            || (m_lists != &m_global
+                && (m_global.rejected.match(recipient)
+                    || m_global.ignored.match(recipient)));
+    }
+
+    Action apply(const CommHistory::Recipient &recipient)
+    {
+        return snapshot(m_providerId).apply(recipient);
+    }
+
+    static AbstractVoiceCallHandler::VoiceCallFilterAction toFilterAction(Action action)
+    {
+        switch (action) {
+        case FILTER_IGNORE:
+            return AbstractVoiceCallHandler::ACTION_IGNORE;
+        case FILTER_REJECT:
+            return AbstractVoiceCallHandler::ACTION_REJECT;
+        default:
+            return AbstractVoiceCallHandler::ACTION_CONTINUE;
+        }
     }
 
-    FilterList m_rejected;
-    FilterList m_ignored;
-    FilterList m_whitelist;
+    Lists m_global;
+    QHash<QString, QSharedPointer<Lists>> m_partitions;
+    QHash<QString, QSharedPointer<Probe>> m_probes; // Providers found without rules.
+    QString m_providerId;
+    Lists *m_lists; // Edited by this filter.
+    QSharedPointer<Latency> m_latency;
 };
 
 Filter::Filter(QObject *parent)
+    : Filter(QString(), parent)
+{
+}
+
+/*
+  Constructs a filter editing the lists of the provider \a providerId,
+  stored under /sailfish/voicecall/filter/providers/ with the provider id
+  escaped. Calls on that line are evaluated against these lists first,
+  and against the global lists when none of them decides.
+
+  An empty \a providerId edits the global lists.
+*/
+Filter::Filter(const QString &providerId, QObject *parent)
     : QObject(parent)
-    , d(new Private)
+    , d(new Private(providerId))
 {
-    connect(&d->m_rejected, &FilterList::changed,
+    connect(&d->m_lists->rejected, &FilterList::changed,
             this, &Filter::rejectedListChanged);
-    connect(&d->m_ignored, &FilterList::changed,
+    connect(&d->m_lists->ignored, &FilterList::changed,
             this, &Filter::ignoredListChanged);
-    connect(&d->m_whitelist, &FilterList::changed,
+    connect(&d->m_lists->whitelist, &FilterList::changed,
             this, &Filter::whiteListChanged);
 }
 
@@ -86,26 +342,31 @@ Filter::~Filter()
 {
 }
 
+QString Filter::providerId() const
+{
+    return d->m_providerId;
+}
+
 QStringList Filter::rejectedList() const
 {
-    return d->m_rejected.list();
+    return d->m_lists->rejected.list();
 }
 
 QStringList Filter::ignoredList() const
 {
-    return d->m_ignored.list();
+    return d->m_lists->ignored.list();
 }
 
 QStringList Filter::whiteList() const
 {
-    return d->m_whitelist.list();
+    return d->m_lists->whitelist.list();
 }
 
 void Filter::ignoreNumber(const QString &number)
 {
-    d->m_whitelist.removeEntry(number);
-    d->m_rejected.removeEntry(number);
-    d->m_ignored.addEntry(number);
+    d->m_lists->whitelist.removeEntry(number);
+    d->m_lists->rejected.removeEntry(number);
+    d->m_lists->ignored.addEntry(number);
 }
 
 void Filter::ignoreNumbersStartingWith(const QString &prefix)
@@ -121,9 +382,9 @@ void Filter::ignoreByDefault()
 
 void Filter::rejectNumber(const QString &number)
 {
-    d->m_whitelist.removeEntry(number);
-    d->m_ignored.removeEntry(number);
-    d->m_rejected.addEntry(number);
+    d->m_lists->whitelist.removeEntry(number);
+    d->m_lists->ignored.removeEntry(number);
+    d->m_lists->rejected.addEntry(number);
 }
 
 void Filter::rejectNumbersStartingWith(const QString &prefix)
@@ -139,14 +400,13 @@ void Filter::rejectByDefault()
 
 void Filter::acceptNumber(const QString &number)
 {
-    d->m_rejected.removeEntry(number);
-    d->m_ignored.removeEntry(number);
+    d->m_lists->rejected.removeEntry(number);
+    d->m_lists->ignored.removeEntry(number);
     const CommHistory::Recipient recipient
         = CommHistory::Recipient::fromPhoneNumber(number);
-    if (d->m_rejected.match(recipient)
-        || d->m_ignored.match(recipient)) {
+    if (d->blocked(recipient)) {
         // Whitelist a number only if it is blocked by a pattern.
-        d->m_whitelist.addEntry(number);
+        d->m_lists->whitelist.addEntry(number);
     }
 }
 
@@ -154,28 +414,69 @@ void Filter::acceptNumbersStartingWith(const QString &prefix)
 {
     QString pattern = prefix;
     pattern.prepend('^');
-    d->m_ignored.removeEntry(pattern);
-    d->m_rejected.removeEntry(pattern);
+    d->m_lists->ignored.removeEntry(pattern);
+    d->m_lists->rejected.removeEntry(pattern);
     const CommHistory::Recipient recipient
         = CommHistory::Recipient::fromPhoneNumber(prefix);
-    if (d->m_rejected.match(recipient)
-        || d->m_ignored.match(recipient)) {
+    if (d->blocked(recipient)) {
         // Whitelist a prefix only if it is blocked by a larger pattern.
-        d->m_whitelist.addEntry(pattern);
+        d->m_lists->whitelist.addEntry(pattern);
     }
 }
 
 void Filter::acceptByDefault()
 {
-    d->m_ignored.removeEntry(QStringLiteral("*"));
-    d->m_rejected.removeEntry(QStringLiteral("*"));
+    d->m_lists->ignored.removeEntry(QStringLiteral("*"));
+    d->m_lists->rejected.removeEntry(QStringLiteral("*"));
 }
 
 void Filter::acceptAll()
 {
-    d->m_ignored.clear();
-    d->m_rejected.clear();
-    d->m_whitelist.clear();
+    d->m_lists->ignored.clear();
+    d->m_lists->rejected.clear();
+    d->m_lists->whitelist.clear();
+    d->m_lists->ignored.removeTable();
+    d->m_lists->rejected.removeTable();
+    d->m_lists->whitelist.removeTable();
+}
+
+/*
+  Starts buffering list mutations in memory. Each list is written
+  once, and notifies its change once, by the matching commitTransaction().
+  Transactions can be nested, only the outermost commit persists.
+*/
+void Filter::beginTransaction()
+{
+    d->m_lists->ignored.beginTransaction();
+    d->m_lists->rejected.beginTransaction();
+    d->m_lists->whitelist.beginTransaction();
+}
+
+void Filter::commitTransaction()
+{
+    d->m_lists->ignored.commitTransaction();
+    d->m_lists->rejected.commitTransaction();
+    d->m_lists->whitelist.commitTransaction();
+}
+
+/*
+  Replaces the bulk ignore table with the numbers listed in
+  \a fileName, one per line. The import runs in the background
+  and ignoredListChanged() is emitted once the table is in use.
+*/
+void Filter::importIgnoredNumbers(const QString &fileName)
+{
+    d->m_lists->ignored.importTable(fileName);
+}
+
+void Filter::importRejectedNumbers(const QString &fileName)
+{
+    d->m_lists->rejected.importTable(fileName);
+}
+
+void Filter::importWhiteListNumbers(const QString &fileName)
+{
+    d->m_lists->whitelist.importTable(fileName);
 }
 
 bool Filter::isIgnored(const QString &number) const
@@ -196,13 +497,104 @@ bool Filter::isAccepted(const QString &number) const
 
 AbstractVoiceCallHandler::VoiceCallFilterAction Filter::evaluate(const AbstractVoiceCallHandler &incomingCall) const
 {
-    switch (d->apply(CommHistory::Recipient(incomingCall.provider()->providerId(),
-                                            incomingCall.lineId()))) {
-    case Private::FILTER_IGNORE:
-        return AbstractVoiceCallHandler::ACTION_IGNORE;
-    case Private::FILTER_REJECT:
-        return AbstractVoiceCallHandler::ACTION_REJECT;
-    default:
-        return AbstractVoiceCallHandler::ACTION_CONTINUE;
+    const QString providerId = incomingCall.provider()->providerId();
+    return Private::toFilterAction(d->snapshot(providerId).evaluate(CommHistory::Recipient(providerId,
+                                                                                           incomingCall.lineId())));
+}
+
+/*
+  Captures the current lists and the caller of incomingCall, and returns
+  a function computing the verdict from them. The function does not
+  touch this object and can be run on any thread, later list changes
+  do not affect it.
+
+  It must be created on the thread owning this filter.
+*/
+Filter::Evaluator Filter::evaluator(const AbstractVoiceCallHandler &incomingCall) const
+{
+    const QString providerId = incomingCall.provider()->providerId();
+    const Private::Snapshot snapshot = d->snapshot(providerId);
+    const CommHistory::Recipient recipient(providerId, incomingCall.lineId());
+    return [snapshot, recipient] () {
+        return Private::toFilterAction(snapshot.evaluate(recipient));
+    };
+}
+
+static QVariantMap hitStatistics(const FilterList &list)
+{
+    const QHash<QString, quint64> hits = list.hits();
+    QVariantMap rules;
+    for (QHash<QString, quint64>::const_iterator it = hits.constBegin();
+         it != hits.constEnd(); ++it) {
+        rules.insert(it.key(), it.value());
+    }
+
+    QVariantMap results;
+    results.insert(QStringLiteral("hits"), rules);
+    results.insert(QStringLiteral("tableHits"), list.tableHits());
+    return results;
+}
+
+static void insertListStatistics(QVariantMap *results, const FilterList &rejected,
+                                 const FilterList &ignored, const FilterList &whitelist)
+{
+    results->insert(QStringLiteral("rejected"), hitStatistics(rejected));
+    results->insert(QStringLiteral("ignored"), hitStatistics(ignored));
+    results->insert(QStringLiteral("whitelist"), hitStatistics(whitelist));
+}
+
+/*
+  Returns what evaluate() and the evaluators recorded since the last
+  resetStatistics():
+  - "rejected", "ignored" and "whitelist" each hold a "hits" map giving
+    how many calls every entry of the list decided, and the number of
+    calls decided by the imported table under "tableHits",
+  - "latency" lists evaluation times by power of two buckets: the
+    first one counts evaluations under a microsecond, bucket i
+    those between 2^(i-1) and 2^i microseconds,
+  - "evaluations" is the total number of evaluations,
+  - "providers" maps the ids of the providers having their own lists
+    to the hits of these lists, laid out as above.
+
+  Counts of entries survive list changes as long as the entry stays.
+*/
+QVariantMap Filter::statistics() const
+{
+    QVariantMap results;
+    insertListStatistics(&results, d->m_global.rejected, d->m_global.ignored,
+                         d->m_global.whitelist);
+
+    QVariantMap providers;
+    for (QHash<QString, QSharedPointer<Private::Lists>>::const_iterator it = d->m_partitions.constBegin();
+         it != d->m_partitions.constEnd(); ++it) {
+        QVariantMap partition;
+        insertListStatistics(&partition, it.value()->rejected, it.value()->ignored,
+                             it.value()->whitelist);
+        providers.insert(it.key(), partition);
+    }
+    results.insert(QStringLiteral("providers"), providers);
+
+    QVariantList latency;
+    quint64 evaluations = 0;
+    for (const std::atomic<quint64> &bucket : d->m_latency->buckets) {
+        const quint64 count = bucket.load(std::memory_order_relaxed);
+        latency.append(count);
+        evaluations += count;
+    }
+    results.insert(QStringLiteral("latency"), latency);
+    results.insert(QStringLiteral("evaluations"), evaluations);
+    return results;
+}
+
+void Filter::resetStatistics()
+{
+    d->m_global.rejected.resetHits();
+    d->m_global.ignored.resetHits();
+    d->m_global.whitelist.resetHits();
+    for (const QSharedPointer<Private::Lists> &partition : d->m_partitions) {
+        partition->rejected.resetHits();
+        partition->ignored.resetHits();
+        partition->whitelist.resetHits();
     }
+    d->m_latency->reset();
 }
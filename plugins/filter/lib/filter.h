@@ -24,11 +24,14 @@
 
 #include <QSharedPointer>
 #include <QObject>
+#include <QVariantMap>
 
 #include <abstractvoicecallhandler.h>
 
 #include <QtCore/QtGlobal>
 
+#include <functional>
+
 #if defined(FILTER_SHARED)
 #  define FILTER_EXPORT Q_DECL_EXPORT
 #else
@@ -41,9 +44,14 @@ class FILTER_EXPORT Filter : public QObject
 {
     Q_OBJECT
 public:
+    typedef std::function<AbstractVoiceCallHandler::VoiceCallFilterAction ()> Evaluator;
+
     Filter(QObject *parent = nullptr);
+    explicit Filter(const QString &providerId, QObject *parent = nullptr);
     ~Filter();
 
+    QString providerId() const;
+
     QStringList ignoredList() const;
     QStringList rejectedList() const;
     QStringList whiteList() const;
@@ -62,11 +70,22 @@ public:
 
     void acceptAll();
 
+    void beginTransaction();
+    void commitTransaction();
+
+    void importIgnoredNumbers(const QString &fileName);
+    void importRejectedNumbers(const QString &fileName);
+    void importWhiteListNumbers(const QString &fileName);
+
     bool isIgnored(const QString &number) const;
     bool isRejected(const QString &number) const;
     bool isAccepted(const QString &number) const;
 
     AbstractVoiceCallHandler::VoiceCallFilterAction evaluate(const AbstractVoiceCallHandler &incomingCall) const;
+    Evaluator evaluator(const AbstractVoiceCallHandler &incomingCall) const;
+
+    QVariantMap statistics() const;
+    void resetStatistics();
 
 signals:
     void ignoredListChanged();
@@ -0,0 +1,466 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "filterindex.h"
+
+#include <common.h>
+
+#include <CommHistory/commonutils.h>
+
+FilterIndex::Hits::Hits(int count)
+    : count(count)
+    , counters(new std::atomic<quint64>[count]())
+{
+}
+
+FilterIndex::FilterIndex()
+    : m_dfa(1)
+    , m_hits(new Hits(1))
+{
+}
+
+FilterIndex::FilterIndex(const QStringList &entries,
+                         const QSharedPointer<const FilterTable> &table,
+                         const FilterIndex *previous)
+    : m_entries(entries)
+    , m_table(table)
+    , m_hits(new Hits(entries.count() + 1))
+{
+    QVector<Pattern> patterns;
+    m_verbatim.reserve(entries.count());
+    for (int rule = 0; rule < entries.count(); rule++) {
+        const QString &filter = entries.at(rule);
+        if (filter.isEmpty() || m_verbatim.contains(filter)) {
+            continue;
+        }
+        m_verbatim.insert(filter, rule);
+        const QString key = numberKey(filter);
+        if (!key.isNull()) {
+            // Exact number matching, keyed like Recipient::matchesRemoteUid().
+            m_numbers.insert(key, rule);
+            continue;
+        }
+        m_otherRules.append(rule);
+        Pattern pattern;
+        pattern.rule = rule;
+        if (filter.startsWith('^')) {
+            // Prefix matching
+            pattern.prefix = true;
+            if (parsePattern(filter.mid(1), &pattern.symbols)) {
+                patterns.append(pattern);
+            } else {
+                // Not a dialable prefix, keep it aside for a plain comparison.
+                m_otherPrefixes.append(qMakePair(filter.mid(1), rule));
+            }
+        } else if (isPattern(filter)) {
+            // Number pattern matching
+            pattern.prefix = false;
+            if (parsePattern(filter, &pattern.symbols)) {
+                patterns.append(pattern);
+            } else {
+                qCWarning(voicecall) << "invalid filter pattern" << filter;
+            }
+        } else if (filter == QStringLiteral("*")) {
+            // All
+            m_matchAll = rule;
+        } else {
+            qCWarning(voicecall) << "unknown filter" << filter;
+        }
+    }
+    compile(patterns);
+
+    // Rules surviving a change keep their counts.
+    if (previous) {
+        for (QHash<QString, int>::const_iterator it = m_verbatim.constBegin();
+             it != m_verbatim.constEnd(); ++it) {
+            const int rule = previous->m_verbatim.value(it.key(), -1);
+            if (rule >= 0) {
+                m_hits->counters[it.value()].store(previous->m_hits->counters[rule].load());
+            }
+        }
+        m_hits->counters[m_entries.count()].store(previous->tableHits());
+    }
+}
+
+FilterIndex::FilterIndex(const FilterIndex &other,
+                         const QSharedPointer<const FilterTable> &table)
+    : FilterIndex(other)
+{
+    m_table = table;
+}
+
+QStringList FilterIndex::entries() const
+{
+    return m_entries;
+}
+
+bool FilterIndex::isEmpty() const
+{
+    return m_entries.isEmpty() && (!m_table || !m_table->count());
+}
+
+int FilterIndex::symbol(QChar c)
+{
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    }
+    switch (u) {
+    case '+':
+        return 10;
+    case '*':
+        return 11;
+    case '#':
+        return 12;
+    default:
+        return -1;
+    }
+}
+
+bool FilterIndex::isSeparator(QChar c)
+{
+    const ushort u = c.unicode();
+    return u == ' ' || u == '-' || u == '.' || u == '(' || u == ')';
+}
+
+bool FilterIndex::isPattern(const QString &filter)
+{
+    for (const QChar c : filter) {
+        const ushort u = c.unicode();
+        if (u == 'x' || u == 'X' || u == '?' || u == '[') {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FilterIndex::parsePattern(const QString &pattern, QVector<quint16> *symbols)
+{
+    const quint16 digits = (1 << 10) - 1;
+
+    symbols->clear();
+    for (int i = 0; i < pattern.length(); i++) {
+        const QChar c = pattern.at(i);
+        const int s = symbol(c);
+        if (s >= 0) {
+            symbols->append(1 << s);
+        } else if (c == 'x' || c == 'X' || c == '?') {
+            symbols->append(digits);
+        } else if (c == '[') {
+            quint16 mask = 0;
+            for (i++; i < pattern.length() && pattern.at(i) != ']'; i++) {
+                const int first = symbol(pattern.at(i));
+                int last = first;
+                if (i + 2 < pattern.length() && pattern.at(i + 1) == '-') {
+                    last = symbol(pattern.at(i + 2));
+                    i += 2;
+                }
+                if (first < 0 || first > 9 || last < first || last > 9) {
+                    return false;
+                }
+                for (int d = first; d <= last; d++) {
+                    mask |= 1 << d;
+                }
+            }
+            if (i == pattern.length() || !mask) {
+                return false;
+            }
+            symbols->append(mask);
+        } else if (!isSeparator(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  Subset construction: a state is the set of pattern positions reached
+  by the same input. All positions of a state share the same offset,
+  so the automaton stays a DAG no deeper than the longest pattern.
+*/
+void FilterIndex::compile(const QVector<Pattern> &patterns)
+{
+    // Pattern index in the high half, offset in the low half, sorted.
+    typedef QVector<quint64> Positions;
+
+    Positions start;
+    start.reserve(patterns.count());
+    for (int i = 0; i < patterns.count(); i++) {
+        start.append(quint64(i) << 32);
+    }
+
+    QVector<Positions> queue;
+    QHash<Positions, quint32> states;
+    m_dfa.clear();
+    m_dfa.append(State());
+    queue.append(start);
+    states.insert(start, 0);
+
+    for (int current = 0; current < queue.count(); current++) {
+        const Positions positions = queue.at(current);
+        Positions next[SymbolCount];
+        int prefixRule = -1;
+        int rule = -1;
+        for (const quint64 position : positions) {
+            const Pattern &pattern = patterns.at(position >> 32);
+            const int offset = position & 0xffffffff;
+            if (offset == pattern.symbols.count()) {
+                int &accept = pattern.prefix ? prefixRule : rule;
+                if (accept < 0 || pattern.rule < accept) {
+                    accept = pattern.rule;
+                }
+                continue;
+            }
+            const quint16 mask = pattern.symbols.at(offset);
+            for (int s = 0; s < SymbolCount; s++) {
+                if (mask & (1 << s)) {
+                    next[s].append(position + 1);
+                }
+            }
+        }
+
+        m_dfa[current].prefixRule = prefixRule;
+        m_dfa[current].rule = rule;
+        if (prefixRule >= 0) {
+            // Nothing further can take over.
+            continue;
+        }
+        for (int s = 0; s < SymbolCount; s++) {
+            if (next[s].isEmpty()) {
+                continue;
+            }
+            QHash<Positions, quint32>::const_iterator it = states.constFind(next[s]);
+            quint32 target;
+            if (it != states.constEnd()) {
+                target = it.value();
+            } else {
+                target = m_dfa.count();
+                m_dfa.append(State());
+                queue.append(next[s]);
+                states.insert(next[s], target);
+            }
+            m_dfa[current].next[s] = target;
+        }
+    }
+    m_dfa.squeeze();
+}
+
+bool FilterIndex::patternMatch(const QString &number, int *rule) const
+{
+    const State *states = m_dfa.constData();
+    quint32 state = 0;
+    bool walking = true;
+    for (const QChar c : number) {
+        if (states[state].prefixRule >= 0) {
+            *rule = states[state].prefixRule;
+            return true;
+        }
+        if (isSeparator(c)) {
+            continue;
+        }
+        const int s = symbol(c);
+        if (s < 0 || !states[state].next[s]) {
+            walking = false;
+            break;
+        }
+        state = states[state].next[s];
+    }
+    if (walking && states[state].prefixRule >= 0) {
+        *rule = states[state].prefixRule;
+        return true;
+    } else if (walking && states[state].rule >= 0) {
+        *rule = states[state].rule;
+        return true;
+    }
+
+    for (const QPair<QString, int> &prefix : m_otherPrefixes) {
+        if (number.startsWith(prefix.first)) {
+            *rule = prefix.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FilterIndex::match(const CommHistory::Recipient &recipient, int *rule) const
+{
+    int matched = -1;
+    if (!rule) {
+        rule = &matched;
+    }
+
+    if (m_matchAll >= 0) {
+        *rule = m_matchAll;
+        return true;
+    }
+
+    const QString &remoteUid = recipient.remoteUid();
+    if (!m_numbers.isEmpty()) {
+        const QString key = CommHistory::minimizePhoneNumber(remoteUid);
+        for (QMultiHash<QString, int>::const_iterator it = m_numbers.constFind(key);
+             it != m_numbers.constEnd() && it.key() == key; ++it) {
+            if (recipient.matchesRemoteUid(m_entries.at(it.value()))) {
+                *rule = it.value();
+                return true;
+            }
+        }
+    }
+    if (m_table && m_table->contains(remoteUid)) {
+        *rule = m_entries.count();
+        return true;
+    }
+
+    return patternMatch(remoteUid, rule);
+}
+
+/*
+  Matches as if the entries in \a excluded were not part of the list.
+  The compiled index is tried first. Only when the rule it finds is
+  excluded are exact numbers looked up again, and the other entries
+  walked one by one.
+*/
+bool FilterIndex::match(const CommHistory::Recipient &recipient,
+                        const QSet<QString> &excluded) const
+{
+    int rule = -1;
+    if (!match(recipient, &rule)) {
+        return false;
+    } else if (excluded.isEmpty() || rule == m_entries.count()
+               || !excluded.contains(m_entries.at(rule))) {
+        return true;
+    }
+
+    const QString &remoteUid = recipient.remoteUid();
+    const QString key = CommHistory::minimizePhoneNumber(remoteUid);
+    for (QMultiHash<QString, int>::const_iterator it = m_numbers.constFind(key);
+         it != m_numbers.constEnd() && it.key() == key; ++it) {
+        const QString &entry = m_entries.at(it.value());
+        if (!excluded.contains(entry) && recipient.matchesRemoteUid(entry)) {
+            return true;
+        }
+    }
+    for (const int other : m_otherRules) {
+        const QString &entry = m_entries.at(other);
+        if (!excluded.contains(entry) && entryMatch(entry, recipient)) {
+            return true;
+        }
+    }
+    return m_table && m_table->contains(remoteUid);
+}
+
+bool FilterIndex::symbolsMatch(const QVector<quint16> &symbols, bool prefix,
+                               const QString &number)
+{
+    int position = 0;
+    for (const QChar c : number) {
+        if (prefix && position == symbols.count()) {
+            return true;
+        }
+        if (isSeparator(c)) {
+            continue;
+        }
+        const int s = symbol(c);
+        if (s < 0 || position == symbols.count() || !(symbols.at(position) & (1 << s))) {
+            return false;
+        }
+        position++;
+    }
+    return position == symbols.count();
+}
+
+// Evaluates a single entry the way the compiled index would.
+bool FilterIndex::entryMatch(const QString &entry, const CommHistory::Recipient &recipient)
+{
+    const QString &remoteUid = recipient.remoteUid();
+    QVector<quint16> symbols;
+    if (entry.isEmpty()) {
+        return false;
+    } else if (entry.startsWith('^')) {
+        return parsePattern(entry.mid(1), &symbols)
+            ? symbolsMatch(symbols, true, remoteUid)
+            : remoteUid.startsWith(entry.mid(1));
+    } else if (isPattern(entry)) {
+        return parsePattern(entry, &symbols) && symbolsMatch(symbols, false, remoteUid);
+    } else if (entry.startsWith('+') || entry[0].isDigit()) {
+        return recipient.matchesRemoteUid(entry);
+    }
+    return entry == QStringLiteral("*");
+}
+
+/*
+  Returns the key an exact number entry is looked up by, or a null
+  string when \a entry is a pattern, a prefix or "*".
+*/
+QString FilterIndex::numberKey(const QString &entry)
+{
+    if (entry.isEmpty() || entry.startsWith('^') || isPattern(entry)
+        || !(entry.startsWith('+') || entry[0].isDigit())) {
+        return QString();
+    }
+    return CommHistory::minimizePhoneNumber(entry);
+}
+
+bool FilterIndex::exactMatch(const QString &number, int *rule) const
+{
+    QHash<QString, int>::const_iterator it = m_verbatim.constFind(number);
+    if (it != m_verbatim.constEnd()) {
+        if (rule) {
+            *rule = it.value();
+        }
+        return true;
+    } else if (m_table && m_table->contains(number)) {
+        if (rule) {
+            *rule = m_entries.count();
+        }
+        return true;
+    }
+    return false;
+}
+
+void FilterIndex::hit(int rule) const
+{
+    if (rule >= 0 && rule < m_hits->count) {
+        m_hits->counters[rule].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QHash<QString, quint64> FilterIndex::hits() const
+{
+    QHash<QString, quint64> results;
+    results.reserve(m_verbatim.count());
+    for (QHash<QString, int>::const_iterator it = m_verbatim.constBegin();
+         it != m_verbatim.constEnd(); ++it) {
+        results.insert(it.key(), m_hits->counters[it.value()].load(std::memory_order_relaxed));
+    }
+    return results;
+}
+
+quint64 FilterIndex::tableHits() const
+{
+    return m_hits->counters[m_hits->count - 1].load(std::memory_order_relaxed);
+}
+
+void FilterIndex::resetHits() const
+{
+    for (int rule = 0; rule < m_hits->count; rule++) {
+        m_hits->counters[rule].store(0, std::memory_order_relaxed);
+    }
+}
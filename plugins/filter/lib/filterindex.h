@@ -0,0 +1,130 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef FILTERINDEX_H
+#define FILTERINDEX_H
+
+#include <QHash>
+#include <QMultiHash>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include <CommHistory/Recipient>
+
+#include "filtertable.h"
+
+#include <atomic>
+#include <memory>
+
+/*
+ * Immutable, compiled form of a filter list.
+ *
+ * Exact numbers are stored by their minimized form, so a lookup costs
+ * one hash probe whatever the list size, and "*" is a flag. An optional
+ * bulk table extends the exact numbers.
+ *
+ * Numbers can also be given as patterns, where "x", "X" or "?" stand for
+ * any digit and "[...]" for a class of digits, with ranges as in "[0-47]".
+ * Space, '-', '.', '(' and ')' are ignored. Patterns match whole numbers,
+ * like "+3315012xxxx", unless they start with '^' where they match the
+ * beginning of numbers, like "^+33[67]". Prefixes and patterns are
+ * compiled together into a DFA run once over the caller number, so
+ * matching is linear in the number length whatever their count.
+ *
+ * Rules are identified by their position in entries(), the table being
+ * one more rule after them. Lists edited in a transaction are matched
+ * against their last index with the removed entries excluded, rather
+ * than being compiled again for every edit. Hit counters are atomic and shared with the
+ * indexes derived from this one, so they can be bumped from any thread.
+ */
+class FilterIndex
+{
+public:
+    FilterIndex();
+    explicit FilterIndex(const QStringList &entries,
+                         const QSharedPointer<const FilterTable> &table = QSharedPointer<const FilterTable>(),
+                         const FilterIndex *previous = nullptr);
+    FilterIndex(const FilterIndex &other, const QSharedPointer<const FilterTable> &table);
+
+    QStringList entries() const;
+    bool isEmpty() const;
+
+    bool match(const CommHistory::Recipient &recipient, int *rule = nullptr) const;
+    bool match(const CommHistory::Recipient &recipient, const QSet<QString> &excluded) const;
+    bool exactMatch(const QString &number, int *rule = nullptr) const;
+
+    static bool entryMatch(const QString &entry, const CommHistory::Recipient &recipient);
+    static QString numberKey(const QString &entry);
+
+    void hit(int rule) const;
+    QHash<QString, quint64> hits() const;
+    quint64 tableHits() const;
+    void resetHits() const;
+
+private:
+    enum {
+        SymbolCount = 13 // 0-9, '+', '*' and '#'.
+    };
+
+    // State 0 is the start, a transition to 0 means no match since
+    // patterns have no loops.
+    struct State {
+        quint32 next[SymbolCount] = {};
+        int prefixRule = -1; // Matches as soon as reached.
+        int rule = -1; // Matches when reached at the end of the number.
+    };
+
+    struct Pattern {
+        QVector<quint16> symbols; // Masks of the symbols accepted at each position.
+        bool prefix;
+        int rule;
+    };
+
+    struct Hits {
+        explicit Hits(int count);
+
+        const int count;
+        std::unique_ptr<std::atomic<quint64>[]> counters;
+    };
+
+    static int symbol(QChar c);
+    static bool isSeparator(QChar c);
+    static bool isPattern(const QString &filter);
+    static bool parsePattern(const QString &pattern, QVector<quint16> *symbols);
+    static bool symbolsMatch(const QVector<quint16> &symbols, bool prefix, const QString &number);
+
+    void compile(const QVector<Pattern> &patterns);
+    bool patternMatch(const QString &number, int *rule) const;
+
+    QStringList m_entries;
+    QHash<QString, int> m_verbatim;
+    QMultiHash<QString, int> m_numbers;
+    QVector<int> m_otherRules; // Those not in m_numbers.
+    QVector<State> m_dfa;
+    QVector<QPair<QString, int>> m_otherPrefixes;
+    int m_matchAll = -1;
+    QSharedPointer<const FilterTable> m_table;
+    QSharedPointer<Hits> m_hits;
+};
+
+#endif
@@ -20,20 +20,183 @@
  */
 
 #include "filterlist.h"
+#include "filterindex.h"
+#include "filtertable.h"
 
 #include <common.h>
 
 #include <MGConfItem>
 
+#include <CommHistory/commonutils.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
 class FilterList::Private
 {
 public:
     Private(const QString &key)
         : m_conf(key)
+        , m_tableFile(tableFile(key))
+    {
+        const QString tableDir = QFileInfo(m_tableFile).absolutePath();
+        if (QDir().mkpath(tableDir)) {
+            m_tableWatcher.addPath(tableDir);
+        }
+        reloadTable();
+    }
+
+    const FilterIndex &index()
+    {
+        // Compile lazily, the index is dropped on every change but
+        // outlives transactions, which only track their edits.
+        if (!m_index) {
+            m_index.reset(new FilterIndex(m_conf.value().toStringList(),
+                                          m_table, m_stale.data()));
+            m_stale.clear();
+        }
+        return *m_index;
+    }
+
+    void dropIndex()
     {
+        // Kept until the next compilation to carry the hit counts over.
+        if (m_index) {
+            m_stale = m_index;
+            m_index.clear();
+        }
+    }
+
+    bool reloadTable()
+    {
+        // The table is replaced by renaming, remap when it changed.
+        const QFileInfo info(m_tableFile);
+        const QDateTime modified = info.exists() ? info.lastModified() : QDateTime();
+        const qint64 size = info.exists() ? info.size() : -1;
+        if (modified == m_tableModified && size == m_tableSize) {
+            return false;
+        }
+        m_tableModified = modified;
+        m_tableSize = size;
+
+        m_table = FilterTable::open(m_tableFile);
+        m_pendingIndex.clear();
+        if (m_index) {
+            m_index.reset(new FilterIndex(*m_index, m_table));
+        }
+        return true;
+    }
+
+    void setPending(const QStringList &entries)
+    {
+        m_pending.clear();
+        m_pendingPositions.clear();
+        for (int position = 0; position < entries.count(); position++) {
+            m_pending.insert(position, entries.at(position));
+            m_pendingPositions.insert(entries.at(position), position);
+        }
+    }
+
+    void prependPending(const QString &entry)
+    {
+        const qint64 position = m_pending.isEmpty() ? 0 : m_pending.firstKey() - 1;
+        m_pending.insert(position, entry);
+        m_pendingPositions.insert(entry, position);
+    }
+
+    void removePending(const QString &entry)
+    {
+        for (const qint64 position : m_pendingPositions.values(entry)) {
+            m_pending.remove(position);
+        }
+        m_pendingPositions.remove(entry);
+    }
+
+    void setAdded(const QSet<QString> &entries)
+    {
+        m_added.clear();
+        m_addedNumbers.clear();
+        m_addedOthers.clear();
+        for (const QString &entry : entries) {
+            insertAdded(entry);
+        }
+    }
+
+    void insertAdded(const QString &entry)
+    {
+        m_added.insert(entry);
+        const QString key = FilterIndex::numberKey(entry);
+        if (key.isNull()) {
+            m_addedOthers.insert(entry);
+        } else {
+            m_addedNumbers.insert(key, entry);
+        }
+    }
+
+    bool removeAdded(const QString &entry)
+    {
+        if (!m_added.remove(entry)) {
+            return false;
+        }
+        const QString key = FilterIndex::numberKey(entry);
+        if (key.isNull()) {
+            m_addedOthers.remove(entry);
+        } else {
+            m_addedNumbers.remove(key, entry);
+        }
+        return true;
+    }
+
+    // Added numbers are looked up, patterns and prefixes walked.
+    bool addedMatch(const CommHistory::Recipient &recipient) const
+    {
+        if (!m_addedNumbers.isEmpty()) {
+            const QString key = CommHistory::minimizePhoneNumber(recipient.remoteUid());
+            for (QMultiHash<QString, QString>::const_iterator it = m_addedNumbers.constFind(key);
+                 it != m_addedNumbers.constEnd() && it.key() == key; ++it) {
+                if (recipient.matchesRemoteUid(it.value())) {
+                    return true;
+                }
+            }
+        }
+        for (const QString &entry : m_addedOthers) {
+            if (FilterIndex::entryMatch(entry, recipient)) {
+                return true;
+            }
+        }
+        return false;
     }
 
     MGConfItem m_conf;
+    QSharedPointer<const FilterIndex> m_index;
+    QSharedPointer<const FilterIndex> m_stale;
+
+    QString m_tableFile;
+    QDateTime m_tableModified;
+    qint64 m_tableSize = -1;
+    QSharedPointer<const FilterTable> m_table;
+    QFileSystemWatcher m_tableWatcher;
+
+    // Edits made during a transaction, persisted by commit().
+    // Entries are matched against the index of the list when the
+    // transaction began, with those added and removed since. Pending
+    // entries are ordered by position, those prepended taking the
+    // positions before the first, so edits need no list scan.
+    int m_transaction = 0;
+    bool m_pendingChanged = false;
+    QMap<qint64, QString> m_pending;
+    QMultiHash<QString, qint64> m_pendingPositions;
+    QSet<QString> m_added;
+    QMultiHash<QString, QString> m_addedNumbers; // By FilterIndex::numberKey().
+    QSet<QString> m_addedOthers;
+    QSet<QString> m_removed;
+    QSharedPointer<const FilterIndex> m_pendingIndex; // Compiled for evaluation only.
 };
 
 FilterList::FilterList(const QString &key, QObject *parent)
@@ -41,13 +204,37 @@ FilterList::FilterList(const QString &key, QObject *parent)
     , d(new Private(key))
 {
     connect(&d->m_conf, &MGConfItem::valueChanged,
-            this, &FilterList::changed);
+            this, [this] () {
+                // Rebuild now rather than on the next incoming call,
+                // an open transaction overwrites the change on commit.
+                if (!d->m_transaction) {
+                    d->dropIndex();
+                    d->index();
+                }
+                emit changed();
+            });
+    connect(&d->m_tableWatcher, &QFileSystemWatcher::directoryChanged,
+            this, [this] () {
+                if (d->reloadTable()) {
+                    emit changed();
+                }
+            });
 }
 
 FilterList::~FilterList()
 {
 }
 
+// Tables are laid out like the keys below the filter root.
+QString FilterList::tableFile(const QString &key)
+{
+    const QString root = QStringLiteral("/sailfish/voicecall/filter/");
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QStringLiteral("/voicecall/filter/")
+        + (key.startsWith(root) ? key.mid(root.length()) : key.section('/', -1))
+        + QStringLiteral(".table");
+}
+
 QString FilterList::key() const
 {
     return d->m_conf.key();
@@ -55,16 +242,40 @@ QString FilterList::key() const
 
 QStringList FilterList::list() const
 {
-    return d->m_conf.value().toStringList();
+    return d->m_transaction ? d->m_pending.values() : d->index().entries();
 }
 
 void FilterList::set(const QStringList &list)
 {
-    d->m_conf.set(list);
+    if (d->m_transaction) {
+        const QStringList entries = d->index().entries();
+        const QSet<QString> committed(entries.constBegin(), entries.constEnd());
+        const QSet<QString> pending(list.constBegin(), list.constEnd());
+        d->setPending(list);
+        d->setAdded(pending - committed);
+        d->m_removed = committed - pending;
+        d->m_pendingChanged = true;
+        d->m_pendingIndex.clear();
+    } else {
+        d->dropIndex();
+        d->m_conf.set(list);
+    }
 }
 
 void FilterList::removeEntry(const QString &entry)
 {
+    if (d->m_transaction) {
+        if (d->m_pendingPositions.contains(entry)) {
+            d->removePending(entry);
+            d->m_pendingChanged = true;
+            if (!d->removeAdded(entry)) {
+                d->m_removed.insert(entry);
+            }
+            d->m_pendingIndex.clear();
+        }
+        return;
+    }
+
     QStringList filters = list();
     if (filters.removeAll(entry) > 0) {
         set(filters);
@@ -73,6 +284,18 @@ void FilterList::removeEntry(const QString &entry)
 
 void FilterList::addEntry(const QString &entry)
 {
+    if (d->m_transaction) {
+        if (!d->m_pendingPositions.contains(entry)) {
+            d->prependPending(entry);
+            d->m_pendingChanged = true;
+            if (!d->m_removed.remove(entry)) {
+                d->insertAdded(entry);
+            }
+            d->m_pendingIndex.clear();
+        }
+        return;
+    }
+
     QStringList filters = list();
     if (!filters.contains(entry)) {
         filters.prepend(entry);
@@ -80,35 +303,111 @@ void FilterList::addEntry(const QString &entry)
     }
 }
 
+void FilterList::beginTransaction()
+{
+    if (d->m_transaction++) {
+        return;
+    }
+    d->setPending(d->index().entries());
+    d->m_pendingChanged = false;
+}
+
+void FilterList::commitTransaction()
+{
+    if (!d->m_transaction || --d->m_transaction) {
+        return;
+    }
+    d->dropIndex();
+    if (d->m_pendingIndex) {
+        d->m_stale = d->m_pendingIndex;
+        d->m_pendingIndex.clear();
+    }
+    if (d->m_pendingChanged) {
+        d->m_conf.set(d->m_pending.values());
+    }
+    d->setPending(QStringList());
+    d->setAdded(QSet<QString>());
+    d->m_removed.clear();
+}
+
 void FilterList::clear()
 {
     set(QStringList());
 }
 
+void FilterList::importTable(const QString &fileName)
+{
+    // Sorting and writing a large feed happens off the main thread,
+    // the new table is mapped once it has been renamed in place.
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished,
+            this, [this, watcher] () {
+                if (!watcher->result()) {
+                    qCWarning(voicecall) << "cannot import filter table" << d->m_tableFile;
+                }
+                if (d->reloadTable()) {
+                    emit changed();
+                }
+                watcher->deleteLater();
+            });
+    watcher->setFuture(QtConcurrent::run(&FilterTable::write, d->m_tableFile, fileName));
+}
+
+void FilterList::removeTable()
+{
+    QFile::remove(d->m_tableFile);
+    if (d->reloadTable()) {
+        emit changed();
+    }
+}
+
+int FilterList::tableCount() const
+{
+    return d->m_table ? d->m_table->count() : 0;
+}
+
 bool FilterList::match(const CommHistory::Recipient &recipient) const
 {
-    for (const QString &filter : list()) {
-        if (filter.startsWith('+') || filter[0].isDigit()) {
-            // Exact number matching
-            if (recipient.matchesRemoteUid(filter)) {
-                return true;
-            }
-        } else if (filter.startsWith('^')) {
-            // Prefix matching
-            if (recipient.remoteUid().startsWith(filter.mid(1))) {
-                return true;
-            }
-        } else if (filter == QStringLiteral("*")) {
-            // All
-            return true;
-        } else {
-            qCWarning(voicecall) << "unknown filter" << filter;
-        }
+    if (d->m_transaction) {
+        return d->addedMatch(recipient) || d->index().match(recipient, d->m_removed);
     }
-    return false;
+    return d->index().match(recipient);
 }
 
 bool FilterList::exactMatch(const QString &number) const
 {
-    return list().contains(number);
+    if (d->m_transaction && d->m_added.contains(number)) {
+        return true;
+    } else if (d->m_transaction && d->m_removed.contains(number)) {
+        return d->m_table && d->m_table->contains(number);
+    }
+    return d->index().exactMatch(number);
+}
+
+QSharedPointer<const FilterIndex> FilterList::snapshot() const
+{
+    // The index is immutable, a reference can be read from any thread.
+    if (d->m_transaction && d->m_pendingChanged) {
+        if (!d->m_pendingIndex) {
+            d->m_pendingIndex.reset(new FilterIndex(d->m_pending.values(), d->m_table, &d->index()));
+        }
+        return d->m_pendingIndex;
+    }
+    d->index();
+    return d->m_index;
+}
+
+QHash<QString, quint64> FilterList::hits() const
+{
+    return d->index().hits();
+}
+
+quint64 FilterList::tableHits() const
+{
+    return d->index().tableHits();
+}
+
+void FilterList::resetHits()
+{
+    d->index().resetHits();
 }
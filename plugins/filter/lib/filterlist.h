@@ -22,11 +22,14 @@
 #ifndef MATCHER_H
 #define MATCHER_H
 
+#include <QHash>
 #include <QSharedPointer>
 #include <QObject>
 
 #include <CommHistory/Recipient>
 
+class FilterIndex;
+
 class FilterList : public QObject
 {
     Q_OBJECT
@@ -34,8 +37,11 @@ public:
     FilterList(const QString &key, QObject *parent = nullptr);
     ~FilterList();
 
+    static QString tableFile(const QString &key);
+
     bool match(const CommHistory::Recipient &recipient) const;
     bool exactMatch(const QString &number) const;
+    QSharedPointer<const FilterIndex> snapshot() const;
     QString key() const;
     QStringList list() const;
     void set(const QStringList &list);
@@ -43,6 +49,17 @@ public:
     void removeEntry(const QString &entry);
     void clear();
 
+    void beginTransaction();
+    void commitTransaction();
+
+    void importTable(const QString &fileName);
+    void removeTable();
+    int tableCount() const;
+
+    QHash<QString, quint64> hits() const;
+    quint64 tableHits() const;
+    void resetHits();
+
 signals:
     void changed();
 
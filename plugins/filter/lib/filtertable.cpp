@@ -0,0 +1,192 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "filtertable.h"
+
+#include <common.h>
+
+#include <CommHistory/commonutils.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char Magic[4] = {'V', 'C', 'F', 'T'};
+const quint32 Version = 1;
+const int RecordSize = 16;
+
+// Stored in host byte order, the table never leaves the device.
+struct Header {
+    char magic[4];
+    quint32 version;
+    quint32 recordSize;
+    quint32 count;
+};
+
+struct Record {
+    char data[RecordSize];
+
+    bool operator<(const Record &other) const
+    {
+        return memcmp(data, other.data, RecordSize) < 0;
+    }
+    bool operator==(const Record &other) const
+    {
+        return memcmp(data, other.data, RecordSize) == 0;
+    }
+};
+
+bool toRecord(const QString &number, Record *record)
+{
+    const QByteArray key = CommHistory::minimizePhoneNumber(number).toLatin1();
+    if (key.isEmpty() || key.size() > RecordSize) {
+        return false;
+    }
+    memset(record->data, 0, RecordSize);
+    memcpy(record->data, key.constData(), key.size());
+    return true;
+}
+
+}
+
+FilterTable::FilterTable()
+{
+}
+
+FilterTable::~FilterTable()
+{
+    // Closing the file releases the mapping.
+}
+
+QSharedPointer<const FilterTable> FilterTable::open(const QString &fileName)
+{
+    QSharedPointer<FilterTable> table(new FilterTable);
+
+    table->m_file.setFileName(fileName);
+    if (!table->m_file.open(QIODevice::ReadOnly)) {
+        return QSharedPointer<const FilterTable>();
+    }
+
+    const qint64 size = table->m_file.size();
+    if (size < qint64(sizeof(Header))) {
+        qCWarning(voicecall) << "truncated filter table" << fileName;
+        return QSharedPointer<const FilterTable>();
+    }
+
+    const uchar *data = table->m_file.map(0, size);
+    if (!data) {
+        qCWarning(voicecall) << "cannot map filter table" << fileName
+                             << table->m_file.errorString();
+        return QSharedPointer<const FilterTable>();
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(data);
+    if (memcmp(header->magic, Magic, sizeof(Magic))
+        || header->version != Version
+        || header->recordSize != RecordSize
+        || size != qint64(sizeof(Header)) + qint64(header->count) * RecordSize) {
+        qCWarning(voicecall) << "invalid filter table" << fileName;
+        return QSharedPointer<const FilterTable>();
+    }
+
+    table->m_records = reinterpret_cast<const char *>(data + sizeof(Header));
+    table->m_count = header->count;
+
+    return table;
+}
+
+bool FilterTable::write(const QString &fileName, const QString &sourceFileName)
+{
+    QFile source(sourceFileName);
+    if (!source.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCWarning(voicecall) << "cannot read numbers from" << sourceFileName;
+        return false;
+    }
+
+    std::vector<Record> records;
+    while (!source.atEnd()) {
+        const QString line = QString::fromUtf8(source.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        Record record;
+        if (toRecord(line, &record)) {
+            records.push_back(record);
+        } else {
+            qCWarning(voicecall) << "skipping filter table entry" << line;
+        }
+    }
+    std::sort(records.begin(), records.end());
+    records.erase(std::unique(records.begin(), records.end()), records.end());
+
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.recordSize = RecordSize;
+    header.count = records.size();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qCWarning(voicecall) << "cannot write filter table" << fileName
+                             << out.errorString();
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(records.data()),
+              qint64(records.size()) * RecordSize);
+    return out.commit();
+}
+
+quint32 FilterTable::count() const
+{
+    return m_count;
+}
+
+bool FilterTable::contains(const QString &number) const
+{
+    Record key;
+    if (!m_count || !toRecord(number, &key)) {
+        return false;
+    }
+
+    quint32 low = 0;
+    quint32 high = m_count;
+    while (low < high) {
+        const quint32 middle = low + (high - low) / 2;
+        const int cmp = memcmp(m_records + qint64(middle) * RecordSize,
+                               key.data, RecordSize);
+        if (cmp < 0) {
+            low = middle + 1;
+        } else if (cmp > 0) {
+            high = middle;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef FILTERTABLE_H
+#define FILTERTABLE_H
+
+#include <QFile>
+#include <QSharedPointer>
+
+/*
+ * Read-only, memory-mapped table of minimized phone numbers.
+ *
+ * The file is a small header followed by fixed-size, NUL-padded
+ * records sorted bytewise, so lookups are a binary search in the
+ * mapping and nothing is loaded into the heap. Files are replaced
+ * atomically by write(), readers keep their mapping until they
+ * drop their reference.
+ */
+class FilterTable
+{
+public:
+    ~FilterTable();
+
+    static QSharedPointer<const FilterTable> open(const QString &fileName);
+    static bool write(const QString &fileName, const QString &sourceFileName);
+
+    quint32 count() const;
+    bool contains(const QString &number) const;
+
+private:
+    FilterTable();
+
+    QFile m_file;
+    const char *m_records = nullptr;
+    quint32 m_count = 0;
+};
+
+#endif
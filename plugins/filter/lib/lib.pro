@@ -1,6 +1,8 @@
 TEMPLATE = lib
 TARGET = voicecall-filter
 
+QT += concurrent
+
 DEFINES += FILTER_SHARED
 
 CONFIG += shared \
@@ -17,11 +19,15 @@ PUBLIC_HEADERS += \
           
 HEADERS += \
     $$PUBLIC_HEADERS \
-    filterlist.h
+    filterlist.h \
+    filterindex.h \
+    filtertable.h
 
 SOURCES += \
     filter.cpp \
-    filterlist.cpp
+    filterlist.cpp \
+    filterindex.cpp \
+    filtertable.cpp
 
 INCLUDEPATH += $$PWD/../../../lib/src
 
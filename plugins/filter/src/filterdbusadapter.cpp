@@ -0,0 +1,54 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "filterdbusadapter.h"
+#include "filter.h"
+
+/*!
+  \class FilterDBusAdapter
+  \brief Exposes the call filter telemetry on D-Bus.
+*/
+FilterDBusAdapter::FilterDBusAdapter(VoiceCall::Filter *filter, QObject *parent)
+    : QDBusAbstractAdaptor(parent)
+    , m_filter(filter)
+{
+}
+
+FilterDBusAdapter::~FilterDBusAdapter()
+{
+}
+
+/*!
+  Returns the per-rule hit counts and the evaluation latency histogram,
+  see VoiceCall::Filter::statistics() for the layout.
+*/
+QVariantMap FilterDBusAdapter::getStatistics() const
+{
+    return m_filter->statistics();
+}
+
+/*!
+  Zeroes the hit counts and the latency histogram.
+*/
+void FilterDBusAdapter::resetStatistics()
+{
+    m_filter->resetStatistics();
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef FILTERDBUSADAPTER_H
+#define FILTERDBUSADAPTER_H
+
+#include <QDBusAbstractAdaptor>
+#include <QVariantMap>
+
+namespace VoiceCall {
+class Filter;
+}
+
+class FilterDBusAdapter : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.nemomobile.voicecall.Filter")
+
+public:
+    FilterDBusAdapter(VoiceCall::Filter *filter, QObject *parent);
+    ~FilterDBusAdapter();
+
+public Q_SLOTS:
+    QVariantMap getStatistics() const;
+    void resetStatistics();
+
+private:
+    VoiceCall::Filter *m_filter;
+};
+
+#endif // FILTERDBUSADAPTER_H
@@ -20,25 +20,52 @@
  */
 
 #include "filterplugin.h"
+#include "filterdbusadapter.h"
 #include "filter.h"
 
+#include <common.h>
 #include <voicecallmanagerinterface.h>
 #include <abstractvoicecallhandler.h>
 
+#include <MGConfItem>
+
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+
+typedef QFutureWatcher<AbstractVoiceCallHandler::VoiceCallFilterAction> VerdictWatcher;
+
 class FilterPlugin::Private
 {
 public:
     Private()
+        : m_timeout(QString::fromLatin1("/sailfish/voicecall/filter/timeout"))
+    {
+        // Calls are evaluated one at a time, in arrival order.
+        m_pool.setMaxThreadCount(1);
+    }
+
+    // Time budget in milliseconds, zero or less evaluates synchronously.
+    int budget() const
     {
+        return m_timeout.value(50).toInt();
     }
 
     VoiceCallManagerInterface *m_manager = nullptr;
     VoiceCall::Filter m_filter;
+    MGConfItem m_timeout;
+    QThreadPool m_pool;
 };
 
 FilterPlugin::FilterPlugin(QObject *parent)
     : AbstractVoiceCallManagerPlugin(parent), d(new Private)
 {
+    new FilterDBusAdapter(&d->m_filter, this);
 }
 
 FilterPlugin::~FilterPlugin()
@@ -64,6 +91,10 @@ bool FilterPlugin::configure(VoiceCallManagerInterface *manager)
 
 bool FilterPlugin::start()
 {
+    if (!QDBusConnection::sessionBus().registerObject(QStringLiteral("/filter"), this)) {
+        qCWarning(voicecall) << "Failed to register DBus object:"
+                             << QDBusConnection::sessionBus().lastError().message();
+    }
     return resume();
 }
 
@@ -85,14 +116,57 @@ bool FilterPlugin::resume()
 
 void FilterPlugin::finalize()
 {
+    QDBusConnection::sessionBus().unregisterObject(QStringLiteral("/filter"));
     suspend();
 }
 
 void FilterPlugin::onVoiceCallAdded(AbstractVoiceCallHandler *handler)
 {
-    if (!handler || !handler->isIncoming()) {
+    // Emergency calls and calls reclaimed after a restart are
+    // released by the manager already.
+    if (!handler || !handler->isIncoming()
+        || handler->status() != AbstractVoiceCallHandler::STATUS_NULL) {
+        return;
+    }
+
+    const int budget = d->budget();
+    if (budget <= 0) {
+        handler->filter(d->m_filter.evaluate(*handler));
         return;
     }
 
-    handler->filter(d->m_filter.evaluate(*handler));
+    // The call stays in STATUS_NULL until filtered, so the verdict must come
+    // within the budget whatever the lists are. Past it, the call is let
+    // through and the late verdict is dropped.
+    const QPointer<AbstractVoiceCallHandler> call(handler);
+    const VoiceCall::Filter::Evaluator evaluator = d->m_filter.evaluator(*handler);
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    VerdictWatcher *watcher = new VerdictWatcher(this);
+    QTimer *deadline = new QTimer(watcher);
+    deadline->setSingleShot(true);
+    connect(deadline, &QTimer::timeout, watcher, [call, budget] () {
+        qCWarning(voicecall) << "call filter exceeded its" << budget
+                             << "ms budget, accepting" << (call ? call->handlerId() : QString());
+        if (call) {
+            call->filter(AbstractVoiceCallHandler::ACTION_CONTINUE);
+        }
+    });
+    // The evaluator is kept until the worker is done with it, so the
+    // captured recipient is always released on this thread.
+    connect(watcher, &VerdictWatcher::finished, this, [call, watcher, deadline, evaluator, elapsed] () {
+        if (deadline->isActive()) {
+            deadline->stop();
+            if (call) {
+                call->filter(watcher->result());
+            }
+        } else {
+            qCWarning(voicecall) << "dropping call filter verdict received after"
+                                 << elapsed.elapsed() << "ms";
+        }
+        watcher->deleteLater();
+    });
+    deadline->start(budget);
+    watcher->setFuture(QtConcurrent::run(&d->m_pool, evaluator));
 }
@@ -3,10 +3,15 @@ TARGET = voicecall-filter-plugin
 
 DEFINES += PLUGIN_NAME=\\\"filter-plugin\\\"
 
+QT += concurrent dbus
+PKGCONFIG += mlite5
+
 INCLUDEPATH += $$PWD/../lib
 
 LIBS += -L$$PWD/../lib -lvoicecall-filter
 
-HEADERS += filterplugin.h
+HEADERS += filterplugin.h \
+    filterdbusadapter.h
 
-SOURCES += filterplugin.cpp
+SOURCES += filterplugin.cpp \
+    filterdbusadapter.cpp
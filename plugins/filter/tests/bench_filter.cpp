@@ -0,0 +1,345 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QDebug>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtGlobal>
+
+#include <filter.h>
+
+#include "stubs.h"
+
+#include <atomic>
+
+// Allocations made by the benchmarked calls, counted by interposing
+// malloc() so that those of Qt containers are seen as well as those
+// of operator new. Only counted with glibc, which exports its own
+// implementation under another name.
+static std::atomic<bool> allocationCounting(false);
+static std::atomic<quint64> allocationCount(0);
+static std::atomic<quint64> allocationBytes(0);
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+static inline void countAllocation(size_t size)
+{
+    if (allocationCounting.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void *malloc(size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+}
+#endif
+
+class bench_filter: public QObject
+{
+    Q_OBJECT
+
+public:
+    bench_filter(QObject *parent = nullptr);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void bench_import_data();
+    void bench_import();
+
+    void bench_evaluate_data();
+    void bench_evaluate();
+
+    void bench_isRejected_data();
+    void bench_isRejected();
+
+    void bench_mutation_data();
+    void bench_mutation();
+
+private:
+    static QStringList numbers(int count, const QString &prefix = QStringLiteral("+3361"), int first = 0);
+    template <typename Function>
+    static void allocations(const char *what, Function function, int calls = 100);
+    bool populate(int count);
+    void sizes();
+
+    QTemporaryDir mTmpHome;
+    Provider mProvider;
+    VoiceCall::Filter *mFilter = nullptr;
+    int mPopulated = -1;
+};
+
+bench_filter::bench_filter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void bench_filter::initTestCase()
+{
+    // This is used not to damage the user DConf database.
+    if (mTmpHome.isValid()) {
+        qputenv("HOME", mTmpHome.path().toUtf8());
+    }
+    mFilter = new VoiceCall::Filter(this);
+}
+
+void bench_filter::cleanupTestCase()
+{
+    mFilter->acceptAll();
+}
+
+QStringList bench_filter::numbers(int count, const QString &prefix, int first)
+{
+    // Numbers differ by their last seven digits, so they stay
+    // distinct once minimized.
+    QStringList results;
+    results.reserve(count);
+    for (int i = first; i < first + count; i++) {
+        results.append(prefix + QStringLiteral("%1").arg(i, 7, 10, QLatin1Char('0')));
+    }
+    return results;
+}
+
+template <typename Function>
+void bench_filter::allocations(const char *what, Function function, int calls)
+{
+#if defined(__GLIBC__)
+    allocationCount.store(0, std::memory_order_relaxed);
+    allocationBytes.store(0, std::memory_order_relaxed);
+    allocationCounting.store(true, std::memory_order_relaxed);
+    for (int i = 0; i < calls; i++) {
+        function();
+    }
+    allocationCounting.store(false, std::memory_order_relaxed);
+    qDebug() << what << "allocations per call:"
+             << double(allocationCount.load(std::memory_order_relaxed)) / calls
+             << "bytes per call:"
+             << double(allocationBytes.load(std::memory_order_relaxed)) / calls;
+#else
+    Q_UNUSED(function);
+    Q_UNUSED(calls);
+    qDebug() << what << "allocations not counted on this C library";
+#endif
+}
+
+/*
+  Fills the lists with a mix of rules: exact numbers are rejected
+  through the bulk table, along with one prefix per hundred numbers,
+  up to a thousand, in GConf. A few numbers are whitelisted and
+  everything else is ignored by the wildcard.
+*/
+bool bench_filter::populate(int count)
+{
+    if (mPopulated == count) {
+        return true;
+    }
+
+    mFilter->acceptAll();
+
+    QFile table(mTmpHome.path() + QStringLiteral("/rejected.txt"));
+    if (!table.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "cannot write" << table.fileName();
+        return false;
+    }
+    for (const QString &number : numbers(count - count / 100)) {
+        table.write(number.toLatin1().append('\n'));
+    }
+    table.close();
+    QSignalSpy rejectedChanged(mFilter, &VoiceCall::Filter::rejectedListChanged);
+    mFilter->importRejectedNumbers(table.fileName());
+    if (rejectedChanged.isEmpty() && !rejectedChanged.wait(120000)) {
+        qWarning() << "table import timed out";
+        return false;
+    }
+
+    mFilter->beginTransaction();
+    for (const QString &prefix : numbers(qMin(count / 100, 1000), QStringLiteral("+3362"))) {
+        mFilter->rejectNumbersStartingWith(prefix);
+    }
+    mFilter->ignoreByDefault();
+    for (const QString &number : numbers(qMin(count, 10), QStringLiteral("+3363"), 5000000)) {
+        mFilter->acceptNumber(number);
+    }
+    mFilter->commitTransaction();
+    mPopulated = count;
+    return true;
+}
+
+void bench_filter::sizes()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void bench_filter::bench_import_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("transaction");
+
+    QTest::newRow("1k one by one") << 1000 << false;
+    QTest::newRow("1k transaction") << 1000 << true;
+    QTest::newRow("5k transaction") << 5000 << true;
+}
+
+void bench_filter::bench_import()
+{
+    QFETCH(int, count);
+    QFETCH(bool, transaction);
+
+    const QStringList entries = numbers(count);
+
+    mFilter->acceptAll();
+    mPopulated = -1;
+    QSignalSpy rejectedChanged(mFilter, &VoiceCall::Filter::rejectedListChanged);
+    QBENCHMARK_ONCE {
+        if (transaction) {
+            mFilter->beginTransaction();
+        }
+        for (const QString &number : entries) {
+            mFilter->rejectNumber(number);
+        }
+        if (transaction) {
+            mFilter->commitTransaction();
+        }
+    }
+    QCOMPARE(mFilter->rejectedList().count(), count);
+    qDebug() << "rejectedListChanged emitted" << rejectedChanged.count() << "times";
+}
+
+void bench_filter::bench_evaluate_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("number");
+    QTest::addColumn<int>("action");
+
+    const struct {
+        const char *name;
+        int count;
+    } sizes[] = {{"10", 10}, {"1k", 1000}, {"100k", 100000}, {"1M", 1000000}};
+    for (const auto &size : sizes) {
+        QTest::newRow(QByteArray(size.name).append(" exact").constData())
+            << size.count << QStringLiteral("+33610000001")
+            << int(AbstractVoiceCallHandler::ACTION_REJECT);
+        QTest::newRow(QByteArray(size.name).append(" whitelist").constData())
+            << size.count << QStringLiteral("+33635000001")
+            << int(AbstractVoiceCallHandler::ACTION_CONTINUE);
+        QTest::newRow(QByteArray(size.name).append(" wildcard").constData())
+            << size.count << QStringLiteral("+14155550100")
+            << int(AbstractVoiceCallHandler::ACTION_IGNORE);
+        if (size.count >= 100) {
+            QTest::newRow(QByteArray(size.name).append(" prefix").constData())
+                << size.count << QStringLiteral("+336200000009876543")
+                << int(AbstractVoiceCallHandler::ACTION_REJECT);
+        }
+    }
+}
+
+void bench_filter::bench_evaluate()
+{
+    QFETCH(int, count);
+    QFETCH(QString, number);
+    QFETCH(int, action);
+
+    QVERIFY(populate(count));
+    const Call call(&mProvider, number);
+    QCOMPARE(int(mFilter->evaluate(call)), action);
+
+    allocations("evaluate()", [this, &call] () { mFilter->evaluate(call); });
+
+    QBENCHMARK {
+        mFilter->evaluate(call);
+    }
+}
+
+void bench_filter::bench_isRejected_data()
+{
+    sizes();
+}
+
+void bench_filter::bench_isRejected()
+{
+    QFETCH(int, count);
+
+    QVERIFY(populate(count));
+    const QString number = QStringLiteral("+33610000001");
+    QVERIFY(mFilter->isRejected(number));
+
+    allocations("isRejected()", [this, &number] () { mFilter->isRejected(number); });
+
+    QBENCHMARK {
+        mFilter->isRejected(number);
+    }
+}
+
+void bench_filter::bench_mutation_data()
+{
+    sizes();
+}
+
+void bench_filter::bench_mutation()
+{
+    QFETCH(int, count);
+
+    QVERIFY(populate(count));
+    const QString number = QStringLiteral("+33649999999");
+
+    allocations("mutation", [this, &number] () {
+        mFilter->rejectNumber(number);
+        mFilter->acceptNumber(number);
+    });
+
+    QBENCHMARK {
+        mFilter->rejectNumber(number);
+        mFilter->acceptNumber(number);
+    }
+    QVERIFY(!mFilter->isRejected(number));
+}
+
+#include "bench_filter.moc"
+QTEST_MAIN(bench_filter)
@@ -0,0 +1,5 @@
+include(tests.pri)
+
+TARGET = bench_filter
+
+SOURCES += bench_filter.cpp
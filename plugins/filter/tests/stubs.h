@@ -0,0 +1,162 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2024  Damien Caliste <dcaliste@free.fr>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef STUBS_H
+#define STUBS_H
+
+#include <abstractvoicecallprovider.h>
+
+class Provider: public AbstractVoiceCallProvider
+{
+    Q_OBJECT
+public:
+    Provider(const QString &providerId = QString::fromLatin1("/org/freedesktop/Telepathy/Account/ring/tel"),
+             QObject *parent = nullptr)
+        : AbstractVoiceCallProvider(parent)
+        , m_providerId(providerId)
+    {
+    }
+    QString providerId() const override
+    {
+        return m_providerId;
+    }
+    QString providerType() const override
+    {
+        return QString();
+    }
+    QList<AbstractVoiceCallHandler*> voiceCalls() const override
+    {
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    QString errorString() const override
+    {
+        return QString();
+    }
+    bool dial(const QString &msisdn) override
+    {
+        Q_UNUSED(msisdn);
+        return false;
+    }
+
+private:
+    QString m_providerId;
+};
+
+class Call: public AbstractVoiceCallHandler
+{
+public:
+    Call(AbstractVoiceCallProvider *provider, const QString &number)
+        : m_lineId(number)
+        , m_provider(provider)
+    {
+    }
+    AbstractVoiceCallProvider* provider() const override
+    {
+        return m_provider;
+    }
+    QString handlerId() const override
+    {
+        return QString();
+    }
+    QString lineId() const override
+    {
+        return m_lineId;
+    }
+    QString subscriberId() const override
+    {
+        return QString();
+    }
+    QDateTime startedAt() const override
+    {
+        return QDateTime();
+    }
+    int duration() const override
+    {
+        return 0;
+    }
+    bool isIncoming() const override
+    {
+        return true;
+    }
+    bool isMultiparty() const override
+    {
+        return false;
+    }
+    bool isEmergency() const override
+    {
+        return false;
+    }
+    bool isForwarded() const override
+    {
+        return false;
+    }
+    bool isRemoteHeld() const override
+    {
+        return false;
+    }
+    QString parentHandlerId() const override
+    {
+        return QString();
+    }
+    QList<AbstractVoiceCallHandler*> childCalls() const override
+    {
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    VoiceCallStatus status() const override
+    {
+        return STATUS_NULL;
+    }
+    void answer() override
+    {
+    }
+    void hangup() override
+    {
+    }  
+    void hold(bool on) override
+    {
+        Q_UNUSED(on);
+    }
+    void deflect(const QString &target) override
+    {
+        Q_UNUSED(target);
+    }
+    void sendDtmf(const QString &tones) override
+    {
+        Q_UNUSED(tones);
+    }
+    void merge(const QString &callHandle) override
+    {
+        Q_UNUSED(callHandle);
+    }
+    void split() override
+    {
+    }
+    void filter(VoiceCallFilterAction action) override
+    {
+        Q_UNUSED(action);
+    }
+
+private:
+    QString m_lineId;
+    AbstractVoiceCallProvider *m_provider;
+};
+
+#endif
@@ -0,0 +1,24 @@
+include(../../plugin.pri)
+
+TEMPLATE = app
+QT += testlib concurrent
+
+PKGCONFIG += mlite5 commhistory-qt5
+
+SRCDIR = $$PWD/../lib
+INCLUDEPATH += $$SRCDIR
+DEPENDPATH = $$INCLUDEPATH
+
+HEADERS += $$SRCDIR/filter.h \
+    $$SRCDIR/filterlist.h \
+    $$SRCDIR/filterindex.h \
+    $$SRCDIR/filtertable.h
+
+HEADERS += $$PWD/stubs.h
+
+SOURCES += $$SRCDIR/filter.cpp \
+    $$SRCDIR/filterlist.cpp \
+    $$SRCDIR/filterindex.cpp \
+    $$SRCDIR/filtertable.cpp
+
+target.path = /opt/tests/voicecall/filter
@@ -20,144 +20,16 @@
  */
 
 #include <QTest>
+#include <QSignalSpy>
 #include <QDebug>
 #include <QObject>
 #include <QTemporaryDir>
 #include <QtGlobal>
+#include <QtConcurrent>
 
 #include <filter.h>
 
-#include <abstractvoicecallprovider.h>
-
-class Provider: public AbstractVoiceCallProvider
-{
-    Q_OBJECT
-public:
-    Provider(QObject *parent = nullptr)
-        : AbstractVoiceCallProvider(parent)
-    {
-    }
-    QString providerId() const override
-    {
-        return QStringLiteral("/org/freedesktop/Telepathy/Account/ring/tel");
-    }
-    QString providerType() const override
-    {
-        return QString();
-    }
-    QList<AbstractVoiceCallHandler*> voiceCalls() const override
-    {
-        return QList<AbstractVoiceCallHandler*>();
-    }
-    QString errorString() const override
-    {
-        return QString();
-    }
-    bool dial(const QString &msisdn) override
-    {
-        Q_UNUSED(msisdn);
-        return false;
-    }
-};
-
-class Call: public AbstractVoiceCallHandler
-{
-public:
-    Call(AbstractVoiceCallProvider *provider, const QString &number)
-        : m_lineId(number)
-        , m_provider(provider)
-    {
-    }
-    AbstractVoiceCallProvider* provider() const override
-    {
-        return m_provider;
-    }
-    QString handlerId() const override
-    {
-        return QString();
-    }
-    QString lineId() const override
-    {
-        return m_lineId;
-    }
-    QString subscriberId() const override
-    {
-        return QString();
-    }
-    QDateTime startedAt() const override
-    {
-        return QDateTime();
-    }
-    int duration() const override
-    {
-        return 0;
-    }
-    bool isIncoming() const override
-    {
-        return true;
-    }
-    bool isMultiparty() const override
-    {
-        return false;
-    }
-    bool isEmergency() const override
-    {
-        return false;
-    }
-    bool isForwarded() const override
-    {
-        return false;
-    }
-    bool isRemoteHeld() const override
-    {
-        return false;
-    }
-    QString parentHandlerId() const override
-    {
-        return QString();
-    }
-    QList<AbstractVoiceCallHandler*> childCalls() const override
-    {
-        return QList<AbstractVoiceCallHandler*>();
-    }
-    VoiceCallStatus status() const override
-    {
-        return STATUS_NULL;
-    }
-    void answer() override
-    {
-    }
-    void hangup() override
-    {
-    }  
-    void hold(bool on) override
-    {
-        Q_UNUSED(on);
-    }
-    void deflect(const QString &target) override
-    {
-        Q_UNUSED(target);
-    }
-    void sendDtmf(const QString &tones) override
-    {
-        Q_UNUSED(tones);
-    }
-    void merge(const QString &callHandle) override
-    {
-        Q_UNUSED(callHandle);
-    }
-    void split() override
-    {
-    }
-    void filter(VoiceCallFilterAction action) override
-    {
-        Q_UNUSED(action);
-    }
-
-private:
-    QString m_lineId;
-    AbstractVoiceCallProvider *m_provider;
-};
+#include "stubs.h"
 
 class tst_filter: public QObject
 {
@@ -179,6 +51,17 @@ private slots:
 
     void tst_overrideAcceptPrefix();
 
+    void tst_nestedPrefixes();
+    void tst_patterns();
+
+    void tst_importTable();
+    void tst_transaction();
+    void tst_transactionLookups();
+
+    void tst_evaluator();
+    void tst_statistics();
+    void tst_providers();
+
 private:
     QTemporaryDir mTmpHome;
     Provider mProvider;
@@ -523,6 +406,300 @@ void tst_filter::tst_overrideAcceptPrefix()
     QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_CONTINUE);
 }
 
+void tst_filter::tst_nestedPrefixes()
+{
+    VoiceCall::Filter filter;
+    const QString prefix1 = QStringLiteral("+15");
+    const QString prefix2 = QStringLiteral("+1555");
+    const Call call1(&mProvider, QStringLiteral("+155578910"));
+    const Call call2(&mProvider, QStringLiteral("+150000000"));
+    const Call call3(&mProvider, QStringLiteral("+1"));
+    const Call call4(&mProvider, prefix2);
+
+    QVERIFY(filter.ignoredList().isEmpty());
+    QVERIFY(filter.rejectedList().isEmpty());
+
+    filter.ignoreNumbersStartingWith(prefix1);
+    filter.rejectNumbersStartingWith(prefix2);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_IGNORE);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_REJECT);
+
+    filter.acceptNumbersStartingWith(prefix2);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_IGNORE);
+    QCOMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_CONTINUE);
+
+    filter.acceptAll();
+    QVERIFY(filter.ignoredList().isEmpty());
+    QVERIFY(filter.rejectedList().isEmpty());
+    QVERIFY(filter.whiteList().isEmpty());
+}
+
+void tst_filter::tst_patterns()
+{
+    VoiceCall::Filter filter;
+    const Call call1(&mProvider, QStringLiteral("+33150121234"));
+    const Call call2(&mProvider, QStringLiteral("+3315012123"));
+    const Call call3(&mProvider, QStringLiteral("+33150131234"));
+    const Call call4(&mProvider, QStringLiteral("+33612345678"));
+    const Call call5(&mProvider, QStringLiteral("+33912345678"));
+    const Call call6(&mProvider, QStringLiteral("+33 6 98 76 54 32"));
+
+    filter.rejectNumber(QStringLiteral("+3315012xxxx"));
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_CONTINUE);
+
+    filter.ignoreNumbersStartingWith(QStringLiteral("+33[67]"));
+    QCOMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_IGNORE);
+    QCOMPARE(filter.evaluate(call5), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call6), AbstractVoiceCallHandler::ACTION_IGNORE);
+
+    // Whole numbers made of classes and ranges, overlapping a prefix.
+    filter.rejectNumber(QStringLiteral("+33[0-59]12?4[5-8]678"));
+    QCOMPARE(filter.evaluate(call5), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_IGNORE);
+
+    // Invalid patterns are skipped.
+    filter.rejectNumber(QStringLiteral("+33[6-"));
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_IGNORE);
+
+    filter.acceptAll();
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+}
+
+void tst_filter::tst_importTable()
+{
+    VoiceCall::Filter filter;
+    const QString number1 = QStringLiteral("+33555789100");
+    const QString number2 = QStringLiteral("0123456789");
+    const Call call1(&mProvider, number1);
+    const Call call2(&mProvider, number2);
+    const Call call3(&mProvider, QStringLiteral("0555789100"));
+
+    QFile numbers(mTmpHome.path() + QStringLiteral("/numbers.txt"));
+    QVERIFY(numbers.open(QIODevice::WriteOnly | QIODevice::Text));
+    numbers.write("# spam feed\n");
+    numbers.write(number1.toUtf8() + '\n');
+    numbers.write(number2.toUtf8() + '\n');
+    numbers.close();
+
+    QSignalSpy rejectedChanged(&filter, &VoiceCall::Filter::rejectedListChanged);
+    filter.importRejectedNumbers(numbers.fileName());
+    QTRY_VERIFY(rejectedChanged.count() > 0);
+    QVERIFY(filter.rejectedList().isEmpty());
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_REJECT);
+
+    // GConf lists keep their precedence over the bulk table.
+    filter.acceptNumber(number1);
+    QCOMPARE(filter.whiteList().count(), 1);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_REJECT);
+
+    rejectedChanged.clear();
+    filter.acceptAll();
+    QTRY_VERIFY(rejectedChanged.count() > 0);
+    QVERIFY(filter.whiteList().isEmpty());
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_CONTINUE);
+}
+
+void tst_filter::tst_transaction()
+{
+    VoiceCall::Filter filter;
+    const QString prefix1 = QStringLiteral("+1555");
+    const QString number1 = QStringLiteral("+155578910");
+    const QString number2 = QStringLiteral("+155523456");
+    const Call call1(&mProvider, number1);
+    const Call call2(&mProvider, number2);
+
+    QVERIFY(filter.rejectedList().isEmpty());
+    QVERIFY(filter.whiteList().isEmpty());
+
+    QSignalSpy rejectedChanged(&filter, &VoiceCall::Filter::rejectedListChanged);
+    filter.beginTransaction();
+    filter.rejectNumbersStartingWith(prefix1);
+    filter.rejectNumber(number2);
+    // Pending edits are visible before the commit.
+    QCOMPARE(filter.rejectedList().count(), 2);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    filter.acceptNumber(number1);
+    QCOMPARE(filter.whiteList().count(), 1);
+    filter.commitTransaction();
+
+    QTRY_COMPARE(rejectedChanged.count(), 1);
+    QCOMPARE(filter.rejectedList().count(), 2);
+    QCOMPARE(filter.rejectedList().first(), number2);
+    QCOMPARE(filter.whiteList().count(), 1);
+    QCOMPARE(filter.whiteList().first(), number1);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_REJECT);
+
+    filter.acceptAll();
+    QVERIFY(filter.rejectedList().isEmpty());
+    QVERIFY(filter.whiteList().isEmpty());
+}
+
+void tst_filter::tst_transactionLookups()
+{
+    VoiceCall::Filter filter;
+    const QString prefix1 = QStringLiteral("+1555");
+    const QString number1 = QStringLiteral("+155578910");
+    const QString number2 = QStringLiteral("+155523456");
+
+    filter.rejectNumbersStartingWith(prefix1);
+    filter.rejectNumber(number2);
+    QCOMPARE(filter.rejectedList().count(), 2);
+    QVERIFY(filter.whiteList().isEmpty());
+
+    filter.beginTransaction();
+    // Still blocked by the prefix.
+    filter.acceptNumber(number2);
+    QCOMPARE(filter.whiteList().count(), 1);
+    QCOMPARE(filter.whiteList().first(), number2);
+    // Removed entries no longer block, even when they are in the index.
+    filter.acceptNumbersStartingWith(prefix1);
+    filter.acceptNumber(number1);
+    QCOMPARE(filter.whiteList().count(), 1);
+    // Nor do entries added and removed again.
+    filter.rejectNumber(number1);
+    QCOMPARE(filter.rejectedList().count(), 1);
+    filter.acceptNumber(number1);
+    QCOMPARE(filter.whiteList().count(), 1);
+    filter.commitTransaction();
+
+    QVERIFY(filter.rejectedList().isEmpty());
+    QCOMPARE(filter.whiteList().count(), 1);
+    QCOMPARE(filter.whiteList().first(), number2);
+
+    filter.acceptAll();
+    QVERIFY(filter.whiteList().isEmpty());
+}
+
+void tst_filter::tst_evaluator()
+{
+    VoiceCall::Filter filter;
+    const QString number1 = QStringLiteral("+33555789100");
+    const QString number2 = QStringLiteral("+33555789200");
+    const Call call1(&mProvider, number1);
+    const Call call2(&mProvider, number2);
+
+    filter.rejectNumber(number1);
+    const VoiceCall::Filter::Evaluator evaluator1 = filter.evaluator(call1);
+    const VoiceCall::Filter::Evaluator evaluator2 = filter.evaluator(call2);
+    QCOMPARE(QtConcurrent::run(evaluator1).result(), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(QtConcurrent::run(evaluator2).result(), AbstractVoiceCallHandler::ACTION_CONTINUE);
+
+    // Evaluators keep the lists they were created with.
+    filter.rejectByDefault();
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(QtConcurrent::run(evaluator2).result(), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(QtConcurrent::run(filter.evaluator(call2)).result(), AbstractVoiceCallHandler::ACTION_REJECT);
+
+    filter.acceptAll();
+    QCOMPARE(QtConcurrent::run(evaluator1).result(), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+}
+
+void tst_filter::tst_statistics()
+{
+    VoiceCall::Filter filter;
+    const QString number1 = QStringLiteral("+33555789100");
+    const QString prefix2 = QStringLiteral("+3355578");
+    const QString number3 = QStringLiteral("+14155550100");
+    const Call call1(&mProvider, number1);
+    const Call call2(&mProvider, QStringLiteral("+33555789200"));
+    const Call call3(&mProvider, number3);
+
+    filter.resetStatistics();
+    filter.rejectNumber(number1);
+    filter.rejectNumbersStartingWith(prefix2);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    // Queries from the settings are not accounted.
+    QVERIFY(filter.isRejected(number1));
+
+    QVariantMap statistics = filter.statistics();
+    QCOMPARE(statistics.value("evaluations").toULongLong(), quint64(4));
+    QVariantMap hits = statistics.value("rejected").toMap().value("hits").toMap();
+    QCOMPARE(hits.count(), 2);
+    QCOMPARE(hits.value(number1).toULongLong(), quint64(2));
+    QCOMPARE(hits.value("^" + prefix2).toULongLong(), quint64(1));
+
+    // Counts follow the entries across list changes.
+    filter.ignoreNumber(number3);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_IGNORE);
+    statistics = filter.statistics();
+    QCOMPARE(statistics.value("evaluations").toULongLong(), quint64(5));
+    hits = statistics.value("rejected").toMap().value("hits").toMap();
+    QCOMPARE(hits.value(number1).toULongLong(), quint64(2));
+    hits = statistics.value("ignored").toMap().value("hits").toMap();
+    QCOMPARE(hits.value(number3).toULongLong(), quint64(1));
+
+    filter.resetStatistics();
+    statistics = filter.statistics();
+    QCOMPARE(statistics.value("evaluations").toULongLong(), quint64(0));
+    hits = statistics.value("rejected").toMap().value("hits").toMap();
+    QCOMPARE(hits.value(number1).toULongLong(), quint64(0));
+
+    filter.acceptAll();
+}
+
+void tst_filter::tst_providers()
+{
+    Provider provider2(QStringLiteral("/ril_1"));
+    VoiceCall::Filter filter;
+    VoiceCall::Filter filter1(mProvider.providerId());
+    VoiceCall::Filter filter2(provider2.providerId());
+    const QString number1 = QStringLiteral("+33555789100");
+    const QString number2 = QStringLiteral("+33555789200");
+    const Call call1(&mProvider, number1);
+    const Call call2(&mProvider, number2);
+    const Call call3(&provider2, number1);
+    const Call call4(&provider2, number2);
+
+    // Lines without rules of their own only use the global lists.
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QVERIFY(filter.statistics().value(QStringLiteral("providers")).toMap().isEmpty());
+
+    QCOMPARE(filter1.providerId(), mProvider.providerId());
+    filter1.rejectNumber(number1);
+    QCOMPARE(filter1.rejectedList().count(), 1);
+    QVERIFY(filter.rejectedList().isEmpty());
+    QVERIFY(filter2.rejectedList().isEmpty());
+    // Lists edited by another instance are picked up on change notification.
+    QTRY_COMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_CONTINUE);
+
+    // Global lists apply to every line when its own lists do not decide.
+    filter.ignoreByDefault();
+    QCOMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_REJECT);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_IGNORE);
+    QCOMPARE(filter.evaluate(call3), AbstractVoiceCallHandler::ACTION_IGNORE);
+    QTRY_VERIFY(filter1.isIgnored(number2));
+    QVERIFY(filter1.isRejected(number1));
+    QVERIFY(filter.isIgnored(number1));
+
+    // A line whitelist overrides the global patterns.
+    filter2.acceptNumber(number2);
+    QCOMPARE(filter2.whiteList().count(), 1);
+    QTRY_COMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QCOMPARE(filter.evaluate(call2), AbstractVoiceCallHandler::ACTION_IGNORE);
+
+    filter.acceptAll();
+    filter1.acceptAll();
+    filter2.acceptAll();
+    QTRY_COMPARE(filter.evaluate(call1), AbstractVoiceCallHandler::ACTION_CONTINUE);
+    QTRY_COMPARE(filter.evaluate(call4), AbstractVoiceCallHandler::ACTION_CONTINUE);
+}
+
 #include "tst_filter.moc"
 QTEST_MAIN(tst_filter)
 
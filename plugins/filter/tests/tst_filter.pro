@@ -0,0 +1,11 @@
+include(tests.pri)
+
+TARGET = tst_filter
+
+SOURCES += tst_filter.cpp
+
+tests_xml.path = /opt/tests/voicecall/filter
+tests_xml.files = tests.xml
+INSTALLS += tests_xml
+
+OTHER_FILES += tests.xml
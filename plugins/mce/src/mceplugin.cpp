@@ -40,14 +40,16 @@ class McePluginPrivate
 public:
     McePluginPrivate(McePlugin *q)
         : q_ptr(q),
-          manager(NULL)
+          manager(NULL), isUpdatePending(false)
     { /* ... */ }
 
     McePlugin *q_ptr;
 
     VoiceCallManagerInterface *manager;
 
-    QHash<QString, AbstractVoiceCallHandler*> calls;
+    // The update reads the state of the calls when it runs, a single
+    // pending one is enough.
+    bool isUpdatePending;
 };
 
 McePlugin::McePlugin(QObject *parent)
@@ -69,6 +71,12 @@ QString McePlugin::pluginId() const
     return PLUGIN_NAME;
 }
 
+AbstractVoiceCallManagerPlugin::Priority McePlugin::priority() const
+{
+    TRACE
+    return PRIORITY_DEFERRED;
+}
+
 bool McePlugin::initialize()
 {
     TRACE
@@ -89,7 +97,8 @@ bool McePlugin::start()
     TRACE
     Q_D(const McePlugin);
 
-    QObject::connect(d->manager, SIGNAL(voiceCallsChanged()), SLOT(onVoiceCallsChanged()));
+    QObject::connect(d->manager, SIGNAL(changeSetCommitted(VoiceCallChangeSet)),
+                     SLOT(onChangeSetCommitted(VoiceCallChangeSet)));
     this->onVoiceCallsChanged();
 
     return true;
@@ -112,71 +121,59 @@ void McePlugin::finalize()
     TRACE
 }
 
+void McePlugin::onChangeSetCommitted(const VoiceCallChangeSet &changes)
+{
+    TRACE
+    Q_D(McePlugin);
+
+    // The call state only depends on the calls, their status and kind.
+    if (!d->isUpdatePending
+            && (changes.voiceCallsChanged()
+                || changes.hasChanged(VoiceCallChangeSet::PROPERTY_STATUS
+                                      | VoiceCallChangeSet::PROPERTY_EMERGENCY))) {
+        d->isUpdatePending = true;
+        d->manager->schedule(this, [d] () {
+            d->isUpdatePending = false;
+            d->q_ptr->onVoiceCallsChanged();
+        });
+    }
+}
+
 void McePlugin::onVoiceCallsChanged()
 {
     TRACE
     Q_D(McePlugin);
 
+    static const AbstractVoiceCallHandler::VoiceCallStatus ActiveStatuses[] = {
+        AbstractVoiceCallHandler::STATUS_DIALING,
+        AbstractVoiceCallHandler::STATUS_ALERTING,
+        AbstractVoiceCallHandler::STATUS_ACTIVE,
+        AbstractVoiceCallHandler::STATUS_HELD,
+        AbstractVoiceCallHandler::STATUS_WAITING
+    };
+
     QString state = "none";
     bool isEmergency = false;
 
     QDBusMessage message = QDBusMessage::createMethodCall(MCE_SERVICE, MCE_PATH, MCE_IFACE, "req_call_state_change");
 
-    if (d->manager->voiceCallCount() == 0) {
-        d->calls.clear();
-    } else {
-        QStringList handlerIds;
-
-        // Go through call handlers and start processing status changes.
-        foreach (AbstractVoiceCallHandler *call, d->manager->voiceCalls()) {
-            handlerIds.append(call->handlerId());
-
-            if (!d->calls.contains(call->handlerId())) {
-                DEBUG_T("Registering call handler from internal dictionary.");
-
-                QObject::connect(call, SIGNAL(statusChanged(VoiceCallStatus)), SLOT(onVoiceCallsChanged()));
-                d->calls.insert(call->handlerId(), call);
-            }
-
-            isEmergency |= call->isEmergency();
-
-            switch(call->status())
-            {
-            case AbstractVoiceCallHandler::STATUS_NULL:
-            case AbstractVoiceCallHandler::STATUS_DISCONNECTED:
-            case AbstractVoiceCallHandler::STATUS_REJECTED:
-            case AbstractVoiceCallHandler::STATUS_IGNORED:
-                continue;
-
-            case AbstractVoiceCallHandler::STATUS_INCOMING:
-                DEBUG_T("RINGING");
-                state = "ringing";
-                continue;
-
-            case AbstractVoiceCallHandler::STATUS_DIALING:
-            case AbstractVoiceCallHandler::STATUS_ALERTING:
-            case AbstractVoiceCallHandler::STATUS_ACTIVE:
-            case AbstractVoiceCallHandler::STATUS_HELD:
-            case AbstractVoiceCallHandler::STATUS_WAITING:
-                DEBUG_T("ACTIVE");
-                if (state != "ringing")
+    if (d->manager->voiceCallCount() > 0) {
+        // The manager keeps calls indexed by status, nothing to scan.
+        if (!d->manager->voiceCallsWithStatus(AbstractVoiceCallHandler::STATUS_INCOMING).isEmpty()) {
+            DEBUG_T("RINGING");
+            state = "ringing";
+        } else {
+            for (AbstractVoiceCallHandler::VoiceCallStatus status : ActiveStatuses) {
+                if (!d->manager->voiceCallsWithStatus(status).isEmpty()) {
+                    DEBUG_T("ACTIVE");
                     state = "active";
-                continue;
+                    break;
+                }
             }
         }
 
-        // Check for, and remove, removed calls from our call dictionary.
-        foreach (QString callId, d->calls.keys()) {
-            if (handlerIds.contains(callId))
-                continue;
-
-            AbstractVoiceCallHandler *call = d->calls.value(callId);
-
-            DEBUG_T("Deregistering call handler from internal dictionary.");
-
-            QObject::disconnect(call, SIGNAL(statusChanged(VoiceCallStatus)), this, SLOT(onVoiceCallsChanged()));
-
-            d->calls.remove(callId);
+        foreach (AbstractVoiceCallHandler *call, d->manager->voiceCalls()) {
+            isEmergency |= call->isEmergency();
         }
     }
 
@@ -26,6 +26,7 @@
 
 #include <abstractvoicecallmanagerplugin.h>
 #include <abstractvoicecallhandler.h>
+#include <voicecallchangeset.h>
 
 class McePlugin : public AbstractVoiceCallManagerPlugin {
     Q_OBJECT
@@ -38,6 +39,7 @@ public:
     ~McePlugin();
 
     QString pluginId() const;
+    Priority priority() const;
 
 public Q_SLOTS:
     bool initialize();
@@ -48,6 +50,7 @@ public Q_SLOTS:
     void finalize();
 
 protected Q_SLOTS:
+    void onChangeSetCommitted(const VoiceCallChangeSet &changes);
     void onVoiceCallsChanged();
 
 private:
@@ -236,8 +236,11 @@ void NgfRingtonePlugin::onEventCompleted(quint32 eventId)
 
 void NgfRingtonePlugin::onEventPlaying(quint32 eventId)
 {
-    Q_UNUSED(eventId)
     TRACE
+    Q_D(NgfRingtonePlugin);
+
+    if (eventId == d->ringtoneEventId && d->currentCall)
+        d->manager->traceVoiceCallEvent(d->currentCall->handlerId(), QStringLiteral("ringtone"));
 }
 
 void NgfRingtonePlugin::onEventPaused(quint32 eventId)
@@ -76,7 +76,8 @@ bool PlaybackManagerPlugin::configure(VoiceCallManagerInterface *manager)
     Q_D(PlaybackManagerPlugin);
     d->manager = manager;
 
-    QObject::connect(d->manager, SIGNAL(voiceCallsChanged()), SLOT(onVoiceCallsChanged()));
+    QObject::connect(d->manager, SIGNAL(changeSetCommitted(VoiceCallChangeSet)),
+                     SLOT(onChangeSetCommitted(VoiceCallChangeSet)));
 
     QObject::connect(d->manager, SIGNAL(setAudioModeRequested(QString)), SLOT(setMode(QString)));
     QObject::connect(d->manager, SIGNAL(setMuteMicrophoneRequested(bool)), SLOT(setMuteMicrophone(bool)));
@@ -172,6 +173,14 @@ void PlaybackManagerPlugin::setMuteSpeaker(bool on)
     d->manager->onMuteSpeakerChanged(on);
 }
 
+void PlaybackManagerPlugin::onChangeSetCommitted(const VoiceCallChangeSet &changes)
+{
+    TRACE
+    if (changes.voiceCallsChanged()) {
+        this->onVoiceCallsChanged();
+    }
+}
+
 void PlaybackManagerPlugin::onVoiceCallsChanged()
 {
     TRACE
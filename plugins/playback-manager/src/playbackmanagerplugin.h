@@ -23,6 +23,7 @@
 
 #include <abstractvoicecallmanagerplugin.h>
 #include <abstractvoicecallhandler.h>
+#include <voicecallchangeset.h>
 
 class PlaybackManagerPlugin : public AbstractVoiceCallManagerPlugin
 {
@@ -51,6 +52,7 @@ public Q_SLOTS:
     void setMuteSpeaker(bool on = true);
 
 protected Q_SLOTS:
+    void onChangeSetCommitted(const VoiceCallChangeSet &changes);
     void onVoiceCallsChanged();
 
 private:
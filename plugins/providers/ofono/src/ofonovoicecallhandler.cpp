@@ -33,13 +33,14 @@ class OfonoVoiceCallHandlerPrivate
     Q_DECLARE_PUBLIC(OfonoVoiceCallHandler)
 
 public:
-    OfonoVoiceCallHandlerPrivate(OfonoVoiceCallHandler *q, const QString &pHandlerId, OfonoVoiceCallProvider *pProvider, QOfonoVoiceCallManager *manager)
-        : q_ptr(q), handlerId(pHandlerId), provider(pProvider), ofonoVoiceCallManager(manager), ofonoVoiceCall(NULL)
-        , duration(0), durationTimerId(-1), isIncoming(false)
+    OfonoVoiceCallHandlerPrivate(OfonoVoiceCallHandler *q, VoiceCallManagerInterface *pManager, OfonoVoiceCallProvider *pProvider, QOfonoVoiceCallManager *ofonoManager)
+        : q_ptr(q), manager(pManager), provider(pProvider), ofonoVoiceCallManager(ofonoManager), ofonoVoiceCall(NULL)
+        , duration(0), durationTimerId(-1), isIncoming(false), isReclaimed(false)
     { /* ... */ }
 
     OfonoVoiceCallHandler *q_ptr;
 
+    VoiceCallManagerInterface *manager;
     QString handlerId;
 
     OfonoVoiceCallProvider *provider;
@@ -51,12 +52,14 @@ public:
     int durationTimerId;
     QElapsedTimer elapsedTimer;
     bool isIncoming;
+    bool isReclaimed;
     bool filterHasRun = false;
     AbstractVoiceCallHandler::VoiceCallFilterAction filterAction = AbstractVoiceCallHandler::ACTION_CONTINUE;
 };
 
-OfonoVoiceCallHandler::OfonoVoiceCallHandler(const QString &handlerId, const QString &path, OfonoVoiceCallProvider *provider, QOfonoVoiceCallManager *manager)
-    : AbstractVoiceCallHandler(provider), d_ptr(new OfonoVoiceCallHandlerPrivate(this, handlerId, provider, manager))
+OfonoVoiceCallHandler::OfonoVoiceCallHandler(VoiceCallManagerInterface *manager, const QString &path,
+                                             OfonoVoiceCallProvider *provider, QOfonoVoiceCallManager *ofonoManager)
+    : AbstractVoiceCallHandler(provider), d_ptr(new OfonoVoiceCallHandlerPrivate(this, manager, provider, ofonoManager))
 {
     TRACE
     Q_D(OfonoVoiceCallHandler);
@@ -87,8 +90,25 @@ void OfonoVoiceCallHandler::onValidChanged(bool isValid)
     Q_D(OfonoVoiceCallHandler);
 
     if (isValid) {
-        // Properties are now ready
-        d->isIncoming = d->ofonoVoiceCall->state() == QLatin1String("incoming");
+        // Properties are now ready, oFono reusing the paths of ended
+        // calls the line and start time tell whether this call is the
+        // one known at its path before a restart of the manager.
+        if (d->handlerId.isEmpty()) {
+            const VoiceCallManagerInterface::ReclaimedVoiceCall call
+                    = d->manager->reclaimVoiceCall(d->provider->providerId(), path(), lineId(), startedAt());
+            d->handlerId = call.handlerId;
+            d->duration = quint64(call.duration) * 1000;
+            d->isIncoming = call.isIncoming;
+            d->isReclaimed = call.isReclaimed;
+        }
+        // A reclaimed call may have been answered meanwhile, its
+        // direction is known from before and its duration is running.
+        if (!d->isReclaimed)
+            d->isIncoming = d->ofonoVoiceCall->state() == QLatin1String("incoming");
+        if (isOngoing() && d->durationTimerId == -1) {
+            d->durationTimerId = this->startTimer(1000);
+            d->elapsedTimer.start();
+        }
     }
 
     emit validChanged(isValid);
@@ -22,6 +22,7 @@
 #define OFONOVOICECALLHANDLER_H
 
 #include <abstractvoicecallhandler.h>
+#include <voicecallmanagerinterface.h>
 
 class OfonoVoiceCallProvider;
 class QOfonoVoiceCallManager;
@@ -33,8 +34,8 @@ class OfonoVoiceCallHandler : public AbstractVoiceCallHandler
     Q_PROPERTY(QString path READ path)
 
 public:
-    explicit OfonoVoiceCallHandler(const QString &handlerId, const QString &path, OfonoVoiceCallProvider *provider,
-                                   QOfonoVoiceCallManager *manager);
+    explicit OfonoVoiceCallHandler(VoiceCallManagerInterface *manager, const QString &path,
+                                   OfonoVoiceCallProvider *provider, QOfonoVoiceCallManager *ofonoManager);
     ~OfonoVoiceCallHandler();
 
     QString path() const;
@@ -181,7 +181,9 @@ void OfonoVoiceCallProvider::onCallAdded(const QString &call)
         return;
 
     qDebug() << "Adding call handler " << call;
-    OfonoVoiceCallHandler *handler = new OfonoVoiceCallHandler(d->manager->generateHandlerId(), call, this, d->ofonoManager);
+    // Calls ongoing across a restart of the manager keep their id,
+    // reclaimed by the handler once its properties are known.
+    OfonoVoiceCallHandler *handler = new OfonoVoiceCallHandler(d->manager, call, this, d->ofonoManager);
     d->invalidVoiceCalls.insert(call, handler);
     QObject::connect(handler, SIGNAL(validChanged(bool)), SLOT(onVoiceCallHandlerValidChanged(bool)));
 }
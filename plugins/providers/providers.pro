@@ -4,3 +4,8 @@ SUBDIRS = ofono
 enable-telepathy {
     SUBDIRS += telepathy
 }
+
+# Provider generating call traffic, for stress testing.
+enable-synthetic {
+    SUBDIRS += synthetic
+}
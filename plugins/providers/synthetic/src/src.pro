@@ -0,0 +1,15 @@
+include(../../../plugin.pri)
+TARGET = voicecall-synthetic-plugin
+QT += dbus
+
+HEADERS += \
+    syntheticvoicecallhandler.h \
+    syntheticvoicecallprovider.h \
+    syntheticvoicecallproviderfactory.h
+
+SOURCES += \
+    syntheticvoicecallhandler.cpp \
+    syntheticvoicecallprovider.cpp \
+    syntheticvoicecallproviderfactory.cpp
+
+DEFINES += PLUGIN_NAME=\\\"voicecall-synthetic-plugin\\\"
@@ -0,0 +1,311 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#include "common.h"
+#include "syntheticvoicecallhandler.h"
+#include "syntheticvoicecallprovider.h"
+
+#include <QTimerEvent>
+
+class SyntheticVoiceCallHandlerPrivate
+{
+    Q_DECLARE_PUBLIC(SyntheticVoiceCallHandler)
+
+public:
+    SyntheticVoiceCallHandlerPrivate(SyntheticVoiceCallHandler *q, const QString &pHandlerId,
+                                     const QString &pLineId, bool pIsIncoming,
+                                     SyntheticVoiceCallProvider *pProvider)
+        : q_ptr(q), handlerId(pHandlerId), lineId(pLineId), provider(pProvider),
+          status(pIsIncoming ? AbstractVoiceCallHandler::STATUS_NULL
+                             : AbstractVoiceCallHandler::STATUS_DIALING),
+          duration(0), durationTimerId(-1), isIncoming(pIsIncoming), isRemoteHeld(false)
+    { /* ... */ }
+
+    SyntheticVoiceCallHandler *q_ptr;
+
+    QString handlerId;
+    QString lineId;
+    QString parentHandlerId;
+    QList<AbstractVoiceCallHandler*> childCalls;
+
+    SyntheticVoiceCallProvider *provider;
+
+    AbstractVoiceCallHandler::VoiceCallStatus status;
+    QDateTime startedAt;
+    int duration;
+    int durationTimerId;
+    bool isIncoming;
+    bool isRemoteHeld;
+};
+
+SyntheticVoiceCallHandler::SyntheticVoiceCallHandler(const QString &handlerId, const QString &lineId, bool isIncoming,
+                                                     SyntheticVoiceCallProvider *provider)
+    : AbstractVoiceCallHandler(provider),
+      d_ptr(new SyntheticVoiceCallHandlerPrivate(this, handlerId, lineId, isIncoming, provider))
+{
+    TRACE
+}
+
+SyntheticVoiceCallHandler::~SyntheticVoiceCallHandler()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    delete d;
+}
+
+AbstractVoiceCallProvider* SyntheticVoiceCallHandler::provider() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->provider;
+}
+
+QString SyntheticVoiceCallHandler::handlerId() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->handlerId;
+}
+
+QString SyntheticVoiceCallHandler::lineId() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->lineId;
+}
+
+QString SyntheticVoiceCallHandler::subscriberId() const
+{
+    TRACE
+    return QString();
+}
+
+QDateTime SyntheticVoiceCallHandler::startedAt() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->startedAt;
+}
+
+int SyntheticVoiceCallHandler::duration() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->duration;
+}
+
+bool SyntheticVoiceCallHandler::isIncoming() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->isIncoming;
+}
+
+bool SyntheticVoiceCallHandler::isMultiparty() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return !d->childCalls.isEmpty() || !d->parentHandlerId.isEmpty();
+}
+
+bool SyntheticVoiceCallHandler::isEmergency() const
+{
+    TRACE
+    return false;
+}
+
+bool SyntheticVoiceCallHandler::isForwarded() const
+{
+    TRACE
+    return false;
+}
+
+bool SyntheticVoiceCallHandler::isRemoteHeld() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->isRemoteHeld;
+}
+
+QString SyntheticVoiceCallHandler::parentHandlerId() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->parentHandlerId;
+}
+
+QList<AbstractVoiceCallHandler*> SyntheticVoiceCallHandler::childCalls() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->childCalls;
+}
+
+AbstractVoiceCallHandler::VoiceCallStatus SyntheticVoiceCallHandler::status() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallHandler);
+    return d->status;
+}
+
+void SyntheticVoiceCallHandler::setStatus(VoiceCallStatus status)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (d->status == status)
+        return;
+
+    d->status = status;
+    if (isOngoing() && !d->startedAt.isValid()) {
+        d->startedAt = QDateTime::currentDateTime();
+        d->durationTimerId = startTimer(1000);
+        emit startedAtChanged(d->startedAt);
+    }
+    if (status == STATUS_DISCONNECTED || status == STATUS_REJECTED) {
+        if (d->durationTimerId != -1) {
+            killTimer(d->durationTimerId);
+            d->durationTimerId = -1;
+        }
+        d->provider->release(this);
+    }
+    emit statusChanged(status);
+}
+
+void SyntheticVoiceCallHandler::setRemoteHeld(bool on)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (d->isRemoteHeld != on) {
+        d->isRemoteHeld = on;
+        emit remoteHeldChanged(on);
+    }
+}
+
+void SyntheticVoiceCallHandler::setParentHandlerId(const QString &handlerId)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (d->parentHandlerId != handlerId) {
+        const bool wasMultiparty = isMultiparty();
+        d->parentHandlerId = handlerId;
+        emit parentHandlerIdChanged(handlerId);
+        if (wasMultiparty != isMultiparty())
+            emit multipartyChanged(isMultiparty());
+    }
+}
+
+void SyntheticVoiceCallHandler::setChildCalls(const QList<AbstractVoiceCallHandler*> &calls)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    const bool wasMultiparty = isMultiparty();
+    d->childCalls = calls;
+    emit childCallsChanged();
+    if (wasMultiparty != isMultiparty())
+        emit multipartyChanged(isMultiparty());
+}
+
+void SyntheticVoiceCallHandler::answer()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (d->status == STATUS_INCOMING || d->status == STATUS_WAITING)
+        d->provider->activate(this);
+}
+
+void SyntheticVoiceCallHandler::hangup()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    foreach (AbstractVoiceCallHandler *child, d->childCalls)
+        child->hangup();
+    if (d->status != STATUS_DISCONNECTED && d->status != STATUS_REJECTED)
+        setStatus(STATUS_DISCONNECTED);
+}
+
+void SyntheticVoiceCallHandler::hold(bool on)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (on && d->status == STATUS_ACTIVE)
+        d->provider->hold(this);
+    else if (!on && d->status == STATUS_HELD)
+        d->provider->activate(this);
+}
+
+void SyntheticVoiceCallHandler::deflect(const QString &target)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    DEBUG_T("Deflecting %s to %s", qPrintable(d->handlerId), qPrintable(target));
+    if (d->status == STATUS_INCOMING || d->status == STATUS_WAITING)
+        setStatus(STATUS_DISCONNECTED);
+}
+
+void SyntheticVoiceCallHandler::sendDtmf(const QString &tones)
+{
+    TRACE
+    Q_UNUSED(tones)
+}
+
+void SyntheticVoiceCallHandler::merge(const QString &callHandle)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    d->provider->merge(d->handlerId, callHandle);
+}
+
+void SyntheticVoiceCallHandler::split()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    d->provider->split(this);
+}
+
+void SyntheticVoiceCallHandler::filter(VoiceCallFilterAction action)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (d->status != STATUS_NULL)
+        return;
+
+    switch (action) {
+    case ACTION_CONTINUE:
+        setStatus(d->provider->hasActiveCall() ? STATUS_WAITING : STATUS_INCOMING);
+        break;
+    case ACTION_IGNORE:
+        // Rings silently until the remote party gives up.
+        setStatus(STATUS_IGNORED);
+        break;
+    case ACTION_REJECT:
+        setStatus(STATUS_REJECTED);
+        break;
+    }
+}
+
+void SyntheticVoiceCallHandler::timerEvent(QTimerEvent *event)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallHandler);
+    if (event->timerId() == d->durationTimerId && isOngoing()) {
+        d->duration++;
+        emit durationChanged(d->duration);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef SYNTHETICVOICECALLHANDLER_H
+#define SYNTHETICVOICECALLHANDLER_H
+
+#include <abstractvoicecallhandler.h>
+
+class SyntheticVoiceCallProvider;
+
+class SyntheticVoiceCallHandler : public AbstractVoiceCallHandler
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticVoiceCallHandler(const QString &handlerId, const QString &lineId, bool isIncoming,
+                                       SyntheticVoiceCallProvider *provider);
+    ~SyntheticVoiceCallHandler();
+
+    AbstractVoiceCallProvider* provider() const;
+
+    QString handlerId() const;
+    QString lineId() const;
+    QString subscriberId() const;
+    QDateTime startedAt() const;
+    int duration() const;
+    bool isIncoming() const;
+    bool isMultiparty() const;
+    bool isEmergency() const;
+    bool isForwarded() const;
+    bool isRemoteHeld() const;
+    QString parentHandlerId() const;
+    QList<AbstractVoiceCallHandler*> childCalls() const;
+
+    VoiceCallStatus status() const;
+
+    // What the network and the remote party do to the call.
+    void setStatus(VoiceCallStatus status);
+    void setRemoteHeld(bool on);
+    void setParentHandlerId(const QString &handlerId);
+    void setChildCalls(const QList<AbstractVoiceCallHandler*> &calls);
+
+public Q_SLOTS:
+    void answer();
+    void hangup();
+    void hold(bool on = true);
+    void deflect(const QString &target);
+    void sendDtmf(const QString &tones);
+    void merge(const QString &callHandle);
+    void split();
+    void filter(VoiceCallFilterAction action);
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private:
+    class SyntheticVoiceCallHandlerPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(SyntheticVoiceCallHandler)
+};
+
+#endif // SYNTHETICVOICECALLHANDLER_H
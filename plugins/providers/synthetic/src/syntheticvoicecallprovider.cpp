@@ -0,0 +1,704 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#include "common.h"
+#include "syntheticvoicecallprovider.h"
+#include "syntheticvoicecallhandler.h"
+
+#include <QHash>
+#include <QTimer>
+
+#include <random>
+
+namespace {
+// Unanswered incoming calls are given up by the caller, in ms.
+const int RingTimeout = 30000;
+const int AlertDelay = 200;
+}
+
+/*!
+  \class SyntheticVoiceCallProvider
+  \brief A provider making up call traffic, to stress the manager and its plugins.
+
+  Calls are placed over D-Bus at /synthetic, one by one, in bursts, as
+  a script, or at random following a load profile given to startLoad():
+
+  \list
+    \li rate: calls started per minute, 60
+    \li incomingRatio: share of incoming calls, 0.7
+    \li answerDelay: ms before incoming calls are answered and outgoing
+        ones accepted, 2000, negative to leave incoming calls ringing
+    \li meanDuration: mean duration of calls in s, 30
+    \li longCallRatio, longDuration: share of calls lasting longDuration
+        s instead, 0.05 and 3600
+    \li burstRatio, burstSize: share of turns bringing in burstSize
+        incoming calls at once, 0.05 and 10
+    \li mergeRatio: share of turns merging the calls into a conference, 0.05
+    \li holdToggleRatio, holdToggles: share of turns toggling hold on
+        an active call holdToggles times, 100 ms apart, 0.05 and 20
+    \li maxCalls: no new calls beyond that many, 50
+    \li seed: of the random generator, for repeatable runs
+  \endlist
+
+  A script has one command per line, calls being named for the later
+  commands:
+
+  \code
+    incoming +15551234 a
+    wait 500
+    answer a
+    outgoing +15555678 b
+    wait 3000
+    merge
+    hold *
+    burst 20
+    hangup *
+  \endcode
+*/
+class SyntheticVoiceCallProviderPrivate
+{
+    Q_DECLARE_PUBLIC(SyntheticVoiceCallProvider)
+
+public:
+    SyntheticVoiceCallProviderPrivate(SyntheticVoiceCallProvider *q, VoiceCallManagerInterface *pManager)
+        : q_ptr(q), manager(pManager)
+    { /* ... */ }
+
+    struct Profile {
+        double rate = 60;
+        double incomingRatio = 0.7;
+        int answerDelay = 2000;
+        double meanDuration = 30;
+        double longCallRatio = 0.05;
+        int longDuration = 3600;
+        double burstRatio = 0.05;
+        int burstSize = 10;
+        double mergeRatio = 0.05;
+        double holdToggleRatio = 0.05;
+        int holdToggles = 20;
+        int maxCalls = 50;
+    };
+
+    SyntheticVoiceCallHandler *newCall(const QString &lineId, bool isIncoming);
+    SyntheticVoiceCallHandler *newConference();
+    void addCall(SyntheticVoiceCallHandler *handler);
+    SyntheticVoiceCallHandler *find(const QString &handlerId) const;
+    QList<SyntheticVoiceCallHandler*> resolve(const QString &name) const;
+    void toggleHold(SyntheticVoiceCallHandler *handler, int times, int interval);
+    void hangupLater(SyntheticVoiceCallHandler *handler, int delay);
+    void answerLater(SyntheticVoiceCallHandler *handler, int delay);
+    bool execute(const QStringList &step);
+
+    double random() { return std::uniform_real_distribution<double>(0, 1)(generator); }
+
+    QString nextLineId()
+    {
+        return QStringLiteral("+1555%1").arg(++lineCounter, 7, 10, QLatin1Char('0'));
+    }
+
+    SyntheticVoiceCallProvider *q_ptr;
+
+    VoiceCallManagerInterface *manager;
+    QList<SyntheticVoiceCallHandler*> voiceCalls;
+    QString errorString;
+
+    Profile profile;
+    QTimer loadTimer;
+    std::mt19937 generator;
+    int lineCounter = 0;
+
+    QList<QStringList> script;
+    QHash<QString, QString> names;
+    QTimer scriptTimer;
+
+    int generated = 0;
+    int incoming = 0;
+    int outgoing = 0;
+    int merges = 0;
+    int holdToggles = 0;
+    int peakCalls = 0;
+};
+
+SyntheticVoiceCallHandler *SyntheticVoiceCallProviderPrivate::newCall(const QString &lineId, bool isIncoming)
+{
+    Q_Q(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *handler = new SyntheticVoiceCallHandler(manager->generateHandlerId(),
+                                                                       lineId, isIncoming, q);
+    generated++;
+    (isIncoming ? incoming : outgoing)++;
+    addCall(handler);
+
+    if (isIncoming) {
+        // The caller gives up unless the call was picked up or rejected.
+        QTimer::singleShot(RingTimeout, handler, [handler] () {
+            switch (handler->status()) {
+            case AbstractVoiceCallHandler::STATUS_NULL:
+            case AbstractVoiceCallHandler::STATUS_INCOMING:
+            case AbstractVoiceCallHandler::STATUS_WAITING:
+            case AbstractVoiceCallHandler::STATUS_IGNORED:
+                handler->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+                break;
+            default:
+                break;
+            }
+        });
+    } else {
+        QTimer::singleShot(AlertDelay, handler, [handler] () {
+            if (handler->status() == AbstractVoiceCallHandler::STATUS_DIALING)
+                handler->setStatus(AbstractVoiceCallHandler::STATUS_ALERTING);
+        });
+        // The remote party picks up.
+        QTimer::singleShot(qMax(AlertDelay, profile.answerDelay), handler, [this, handler] () {
+            if (handler->status() == AbstractVoiceCallHandler::STATUS_ALERTING)
+                q_ptr->activate(handler);
+        });
+    }
+    return handler;
+}
+
+/*
+  Conferences are neither dialed nor answered, they are active from the
+  start and not counted as generated calls.
+*/
+SyntheticVoiceCallHandler *SyntheticVoiceCallProviderPrivate::newConference()
+{
+    Q_Q(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *handler = new SyntheticVoiceCallHandler(manager->generateHandlerId(),
+                                                                       QString(), false, q);
+    handler->setStatus(AbstractVoiceCallHandler::STATUS_ACTIVE);
+    addCall(handler);
+    return handler;
+}
+
+void SyntheticVoiceCallProviderPrivate::addCall(SyntheticVoiceCallHandler *handler)
+{
+    Q_Q(SyntheticVoiceCallProvider);
+    voiceCalls.append(handler);
+    peakCalls = qMax(peakCalls, voiceCalls.count());
+
+    emit q->voiceCallAdded(handler);
+    emit q->voiceCallsChanged();
+}
+
+SyntheticVoiceCallHandler *SyntheticVoiceCallProviderPrivate::find(const QString &handlerId) const
+{
+    foreach (SyntheticVoiceCallHandler *handler, voiceCalls) {
+        if (handler->handlerId() == handlerId)
+            return handler;
+    }
+    return NULL;
+}
+
+// A script name, a handler id, or * for every call.
+QList<SyntheticVoiceCallHandler*> SyntheticVoiceCallProviderPrivate::resolve(const QString &name) const
+{
+    if (name == QLatin1String("*"))
+        return voiceCalls;
+
+    QList<SyntheticVoiceCallHandler*> result;
+    SyntheticVoiceCallHandler *handler = find(names.value(name, name));
+    if (handler)
+        result.append(handler);
+    return result;
+}
+
+void SyntheticVoiceCallProviderPrivate::toggleHold(SyntheticVoiceCallHandler *handler, int times, int interval)
+{
+    if (times <= 0 || !handler->isOngoing())
+        return;
+
+    handler->hold(handler->status() == AbstractVoiceCallHandler::STATUS_ACTIVE);
+    holdToggles++;
+    QTimer::singleShot(interval, handler, [this, handler, times, interval] () {
+        toggleHold(handler, times - 1, interval);
+    });
+}
+
+void SyntheticVoiceCallProviderPrivate::hangupLater(SyntheticVoiceCallHandler *handler, int delay)
+{
+    QTimer::singleShot(delay, handler, [handler] () {
+        if (handler->status() != AbstractVoiceCallHandler::STATUS_DISCONNECTED)
+            handler->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    });
+}
+
+void SyntheticVoiceCallProviderPrivate::answerLater(SyntheticVoiceCallHandler *handler, int delay)
+{
+    if (delay < 0)
+        return;
+    QTimer::singleShot(delay, handler, [handler] () {
+        handler->answer();
+    });
+}
+
+bool SyntheticVoiceCallProviderPrivate::execute(const QStringList &step)
+{
+    Q_Q(SyntheticVoiceCallProvider);
+    const QString command = step.value(0);
+    const QString argument = step.value(1);
+
+    if (command == QLatin1String("incoming") || command == QLatin1String("outgoing")) {
+        const QString lineId = argument.isEmpty() ? nextLineId() : argument;
+        SyntheticVoiceCallHandler *handler = newCall(lineId, command == QLatin1String("incoming"));
+        if (step.count() > 2)
+            names.insert(step.at(2), handler->handlerId());
+    } else if (command == QLatin1String("burst")) {
+        q->burst(argument.toInt());
+    } else if (command == QLatin1String("answer")) {
+        foreach (SyntheticVoiceCallHandler *handler, resolve(argument))
+            handler->answer();
+    } else if (command == QLatin1String("hangup")) {
+        foreach (SyntheticVoiceCallHandler *handler, resolve(argument))
+            q->remoteHangup(handler->handlerId());
+    } else if (command == QLatin1String("hold") || command == QLatin1String("unhold")) {
+        foreach (SyntheticVoiceCallHandler *handler, resolve(argument))
+            handler->hold(command == QLatin1String("hold"));
+    } else if (command == QLatin1String("toggle")) {
+        foreach (SyntheticVoiceCallHandler *handler, resolve(argument))
+            toggleHold(handler, step.value(2, QStringLiteral("10")).toInt(), 100);
+    } else if (command == QLatin1String("merge")) {
+        q->mergeAll();
+    } else if (command == QLatin1String("split")) {
+        foreach (SyntheticVoiceCallHandler *handler, resolve(argument))
+            q->split(handler);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+SyntheticVoiceCallProvider::SyntheticVoiceCallProvider(VoiceCallManagerInterface *manager, QObject *parent)
+    : AbstractVoiceCallProvider(parent), d_ptr(new SyntheticVoiceCallProviderPrivate(this, manager))
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    QObject::connect(&d->loadTimer, SIGNAL(timeout()), SLOT(onLoadTimeout()));
+    d->scriptTimer.setSingleShot(true);
+    QObject::connect(&d->scriptTimer, SIGNAL(timeout()), SLOT(onScriptStep()));
+}
+
+SyntheticVoiceCallProvider::~SyntheticVoiceCallProvider()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    delete d;
+}
+
+QString SyntheticVoiceCallProvider::providerId() const
+{
+    TRACE
+    return QStringLiteral("synthetic");
+}
+
+QString SyntheticVoiceCallProvider::providerType() const
+{
+    TRACE
+    return QStringLiteral("synthetic");
+}
+
+QList<AbstractVoiceCallHandler*> SyntheticVoiceCallProvider::voiceCalls() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallProvider);
+    QList<AbstractVoiceCallHandler*> result;
+    foreach (SyntheticVoiceCallHandler *handler, d->voiceCalls)
+        result.append(handler);
+    return result;
+}
+
+QString SyntheticVoiceCallProvider::errorString() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallProvider);
+    return d->errorString;
+}
+
+bool SyntheticVoiceCallProvider::hasActiveCall() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallProvider);
+    foreach (SyntheticVoiceCallHandler *handler, d->voiceCalls) {
+        if (handler->status() == AbstractVoiceCallHandler::STATUS_ACTIVE)
+            return true;
+    }
+    return false;
+}
+
+/*!
+  Makes \a handler, along with the calls of its conference, the active
+  call, holding the one active so far.
+*/
+void SyntheticVoiceCallProvider::activate(SyntheticVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *conference = d->find(handler->parentHandlerId());
+    if (conference)
+        handler = conference;
+
+    foreach (SyntheticVoiceCallHandler *other, d->voiceCalls) {
+        if (other != handler && other->parentHandlerId() != handler->handlerId()
+                && other->status() == AbstractVoiceCallHandler::STATUS_ACTIVE)
+            other->setStatus(AbstractVoiceCallHandler::STATUS_HELD);
+    }
+    handler->setStatus(AbstractVoiceCallHandler::STATUS_ACTIVE);
+    foreach (AbstractVoiceCallHandler *child, handler->childCalls())
+        static_cast<SyntheticVoiceCallHandler *>(child)->setStatus(AbstractVoiceCallHandler::STATUS_ACTIVE);
+}
+
+void SyntheticVoiceCallProvider::hold(SyntheticVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *conference = d->find(handler->parentHandlerId());
+    if (conference)
+        handler = conference;
+
+    handler->setStatus(AbstractVoiceCallHandler::STATUS_HELD);
+    foreach (AbstractVoiceCallHandler *child, handler->childCalls())
+        static_cast<SyntheticVoiceCallHandler *>(child)->setStatus(AbstractVoiceCallHandler::STATUS_HELD);
+}
+
+/*!
+  Joins two calls, or a call and a conference, into a conference.
+*/
+void SyntheticVoiceCallProvider::merge(const QString &handlerId, const QString &otherHandlerId)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *first = d->find(handlerId);
+    SyntheticVoiceCallHandler *second = d->find(otherHandlerId);
+    if (!first || !second || first == second || !first->isOngoing() || !second->isOngoing())
+        return;
+
+    if (d->find(first->parentHandlerId()))
+        first = d->find(first->parentHandlerId());
+    if (d->find(second->parentHandlerId()))
+        second = d->find(second->parentHandlerId());
+    if (first == second)
+        return;
+
+    SyntheticVoiceCallHandler *conference = !first->childCalls().isEmpty() ? first
+            : !second->childCalls().isEmpty() ? second : NULL;
+    if (!conference)
+        conference = d->newConference();
+
+    QList<AbstractVoiceCallHandler*> children = conference->childCalls();
+    foreach (SyntheticVoiceCallHandler *call, QList<SyntheticVoiceCallHandler*>() << first << second) {
+        if (call == conference)
+            continue;
+        // Merging conferences brings their calls along.
+        QList<AbstractVoiceCallHandler*> joining = call->childCalls();
+        if (joining.isEmpty())
+            joining.append(call);
+        foreach (AbstractVoiceCallHandler *child, joining) {
+            static_cast<SyntheticVoiceCallHandler *>(child)->setParentHandlerId(conference->handlerId());
+            children.append(child);
+        }
+        if (call->childCalls().count()) {
+            call->setChildCalls(QList<AbstractVoiceCallHandler*>());
+            call->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+        }
+    }
+    conference->setChildCalls(children);
+    d->merges++;
+    activate(conference);
+}
+
+/*!
+  Takes \a handler out of its conference and makes it the active call,
+  the conference ends once down to a single call.
+*/
+void SyntheticVoiceCallProvider::split(SyntheticVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *conference = d->find(handler->parentHandlerId());
+    if (!conference)
+        return;
+
+    QList<AbstractVoiceCallHandler*> children = conference->childCalls();
+    children.removeOne(handler);
+    handler->setParentHandlerId(QString());
+
+    if (children.count() < 2) {
+        foreach (AbstractVoiceCallHandler *child, children)
+            static_cast<SyntheticVoiceCallHandler *>(child)->setParentHandlerId(QString());
+        conference->setChildCalls(QList<AbstractVoiceCallHandler*>());
+        conference->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    } else {
+        conference->setChildCalls(children);
+    }
+    activate(handler);
+}
+
+/*!
+  Drops \a handler once ended, the manager deleting it.
+*/
+void SyntheticVoiceCallProvider::release(SyntheticVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    if (!d->voiceCalls.removeOne(handler))
+        return;
+
+    SyntheticVoiceCallHandler *conference = d->find(handler->parentHandlerId());
+    if (conference) {
+        QList<AbstractVoiceCallHandler*> children = conference->childCalls();
+        children.removeOne(handler);
+        conference->setChildCalls(children);
+        if (children.isEmpty())
+            conference->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    }
+
+    // Removed once the status change went through.
+    const QString handlerId = handler->handlerId();
+    QTimer::singleShot(0, this, [this, handlerId] () {
+        emit voiceCallRemoved(handlerId);
+        emit voiceCallsChanged();
+    });
+}
+
+bool SyntheticVoiceCallProvider::dial(const QString &msisdn)
+{
+    TRACE
+    outgoing(msisdn);
+    return true;
+}
+
+/*!
+  Places an incoming call from \a lineId, or a made up number if
+  empty, and returns its handler id.
+*/
+QString SyntheticVoiceCallProvider::incoming(const QString &lineId)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    return d->newCall(lineId.isEmpty() ? d->nextLineId() : lineId, true)->handlerId();
+}
+
+/*!
+  Places an outgoing call to \a lineId, accepted by the remote party
+  after the answer delay of the load profile.
+*/
+QString SyntheticVoiceCallProvider::outgoing(const QString &lineId)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    return d->newCall(lineId.isEmpty() ? d->nextLineId() : lineId, false)->handlerId();
+}
+
+QStringList SyntheticVoiceCallProvider::burst(int count)
+{
+    TRACE
+    QStringList result;
+    for (int i = 0; i < count; i++)
+        result.append(incoming(QString()));
+    return result;
+}
+
+bool SyntheticVoiceCallProvider::remoteHangup(const QString &handlerId)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *handler = d->find(handlerId);
+    if (!handler)
+        return false;
+
+    foreach (AbstractVoiceCallHandler *child, handler->childCalls())
+        static_cast<SyntheticVoiceCallHandler *>(child)->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    handler->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+    return true;
+}
+
+void SyntheticVoiceCallProvider::hangupAll()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    foreach (SyntheticVoiceCallHandler *handler, d->voiceCalls)
+        handler->setStatus(AbstractVoiceCallHandler::STATUS_DISCONNECTED);
+}
+
+bool SyntheticVoiceCallProvider::toggleHold(const QString &handlerId, int times, int interval)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallHandler *handler = d->find(handlerId);
+    if (!handler || !handler->isOngoing())
+        return false;
+
+    d->toggleHold(handler, times, qMax(0, interval));
+    return true;
+}
+
+/*!
+  Merges every ongoing call into a single conference.
+*/
+bool SyntheticVoiceCallProvider::mergeAll()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    QStringList ongoing;
+    foreach (SyntheticVoiceCallHandler *handler, d->voiceCalls) {
+        if (handler->isOngoing() && handler->parentHandlerId().isEmpty())
+            ongoing.append(handler->handlerId());
+    }
+    if (ongoing.count() < 2)
+        return false;
+
+    for (int i = 1; i < ongoing.count(); i++) {
+        SyntheticVoiceCallHandler *first = d->find(ongoing.first());
+        // The first call may have become part of the conference.
+        merge(first && !first->parentHandlerId().isEmpty() ? first->parentHandlerId() : ongoing.first(),
+              ongoing.at(i));
+    }
+    return true;
+}
+
+void SyntheticVoiceCallProvider::startLoad(const QVariantMap &profile)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    SyntheticVoiceCallProviderPrivate::Profile p;
+    p.rate = profile.value(QStringLiteral("rate"), p.rate).toDouble();
+    p.incomingRatio = profile.value(QStringLiteral("incomingRatio"), p.incomingRatio).toDouble();
+    p.answerDelay = profile.value(QStringLiteral("answerDelay"), p.answerDelay).toInt();
+    p.meanDuration = profile.value(QStringLiteral("meanDuration"), p.meanDuration).toDouble();
+    p.longCallRatio = profile.value(QStringLiteral("longCallRatio"), p.longCallRatio).toDouble();
+    p.longDuration = profile.value(QStringLiteral("longDuration"), p.longDuration).toInt();
+    p.burstRatio = profile.value(QStringLiteral("burstRatio"), p.burstRatio).toDouble();
+    p.burstSize = profile.value(QStringLiteral("burstSize"), p.burstSize).toInt();
+    p.mergeRatio = profile.value(QStringLiteral("mergeRatio"), p.mergeRatio).toDouble();
+    p.holdToggleRatio = profile.value(QStringLiteral("holdToggleRatio"), p.holdToggleRatio).toDouble();
+    p.holdToggles = profile.value(QStringLiteral("holdToggles"), p.holdToggles).toInt();
+    p.maxCalls = profile.value(QStringLiteral("maxCalls"), p.maxCalls).toInt();
+    if (p.rate <= 0 || p.meanDuration <= 0) {
+        WARNING_T("Invalid synthetic load profile");
+        return;
+    }
+
+    d->profile = p;
+    if (profile.contains(QStringLiteral("seed")))
+        d->generator.seed(profile.value(QStringLiteral("seed")).toUInt());
+    d->loadTimer.start(qMax(1, int(60000 / p.rate)));
+    DEBUG_T("Synthetic load started, %g calls per minute", p.rate);
+}
+
+void SyntheticVoiceCallProvider::stopLoad()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    d->loadTimer.stop();
+}
+
+/*!
+  Runs \a script, see the class description. Returns false, without
+  running anything, if a command is not known.
+*/
+bool SyntheticVoiceCallProvider::runScript(const QString &script)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    static const QStringList Commands = QStringList()
+            << "incoming" << "outgoing" << "burst" << "wait" << "answer" << "hangup"
+            << "hold" << "unhold" << "toggle" << "merge" << "split";
+
+    QList<QStringList> steps;
+    foreach (const QString &line, script.split(QLatin1Char('\n'))) {
+        const QStringList step = line.simplified().split(QLatin1Char(' '), QString::SkipEmptyParts);
+        if (step.isEmpty() || step.first().startsWith(QLatin1Char('#')))
+            continue;
+        if (!Commands.contains(step.first())) {
+            WARNING_T("Unknown synthetic script command: %s", qPrintable(step.first()));
+            return false;
+        }
+        steps.append(step);
+    }
+
+    d->script = steps;
+    d->names.clear();
+    d->scriptTimer.start(0);
+    return true;
+}
+
+QVariantMap SyntheticVoiceCallProvider::statistics() const
+{
+    TRACE
+    Q_D(const SyntheticVoiceCallProvider);
+    QVariantMap result;
+    result.insert(QStringLiteral("generated"), d->generated);
+    result.insert(QStringLiteral("incoming"), d->incoming);
+    result.insert(QStringLiteral("outgoing"), d->outgoing);
+    result.insert(QStringLiteral("calls"), d->voiceCalls.count());
+    result.insert(QStringLiteral("peakCalls"), d->peakCalls);
+    result.insert(QStringLiteral("merges"), d->merges);
+    result.insert(QStringLiteral("holdToggles"), d->holdToggles);
+    result.insert(QStringLiteral("loadRunning"), d->loadTimer.isActive());
+    return result;
+}
+
+void SyntheticVoiceCallProvider::onLoadTimeout()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    const SyntheticVoiceCallProviderPrivate::Profile &p = d->profile;
+    if (d->voiceCalls.count() >= p.maxCalls)
+        return;
+
+    double pick = d->random();
+    if ((pick -= p.burstRatio) < 0) {
+        burst(qMin(p.burstSize, p.maxCalls - d->voiceCalls.count()));
+        return;
+    }
+    if ((pick -= p.mergeRatio) < 0 && mergeAll())
+        return;
+    if ((pick -= p.holdToggleRatio) < 0) {
+        foreach (SyntheticVoiceCallHandler *handler, d->voiceCalls) {
+            if (handler->status() == AbstractVoiceCallHandler::STATUS_ACTIVE) {
+                d->toggleHold(handler, p.holdToggles, 100);
+                return;
+            }
+        }
+    }
+
+    const bool isIncoming = d->random() < p.incomingRatio;
+    SyntheticVoiceCallHandler *handler = d->newCall(d->nextLineId(), isIncoming);
+    if (isIncoming)
+        d->answerLater(handler, p.answerDelay);
+
+    const double seconds = d->random() < p.longCallRatio
+            ? p.longDuration
+            : std::exponential_distribution<double>(1.0 / p.meanDuration)(d->generator);
+    d->hangupLater(handler, qMax(0, p.answerDelay) + int(seconds * 1000));
+}
+
+void SyntheticVoiceCallProvider::onScriptStep()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProvider);
+    while (!d->script.isEmpty()) {
+        const QStringList step = d->script.takeFirst();
+        if (step.first() == QLatin1String("wait")) {
+            d->scriptTimer.start(qMax(0, step.value(1).toInt()));
+            return;
+        }
+        d->execute(step);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef SYNTHETICVOICECALLPROVIDER_H
+#define SYNTHETICVOICECALLPROVIDER_H
+
+#include <abstractvoicecallprovider.h>
+#include <voicecallmanagerinterface.h>
+
+#include <QStringList>
+#include <QVariantMap>
+
+class SyntheticVoiceCallHandler;
+
+class SyntheticVoiceCallProvider : public AbstractVoiceCallProvider
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.nemomobile.voicecall.Synthetic")
+
+public:
+    explicit SyntheticVoiceCallProvider(VoiceCallManagerInterface *manager, QObject *parent = 0);
+    ~SyntheticVoiceCallProvider();
+
+    QString providerId() const;
+    QString providerType() const;
+    QList<AbstractVoiceCallHandler*> voiceCalls() const;
+    QString errorString() const;
+
+    // Used by the handlers.
+    bool hasActiveCall() const;
+    void activate(SyntheticVoiceCallHandler *handler);
+    void hold(SyntheticVoiceCallHandler *handler);
+    void merge(const QString &handlerId, const QString &otherHandlerId);
+    void split(SyntheticVoiceCallHandler *handler);
+    void release(SyntheticVoiceCallHandler *handler);
+
+public Q_SLOTS:
+    bool dial(const QString &msisdn);
+
+    // The control interface, on the bus at /synthetic.
+    Q_SCRIPTABLE QString incoming(const QString &lineId);
+    Q_SCRIPTABLE QString outgoing(const QString &lineId);
+    Q_SCRIPTABLE QStringList burst(int count);
+    Q_SCRIPTABLE bool remoteHangup(const QString &handlerId);
+    Q_SCRIPTABLE void hangupAll();
+    Q_SCRIPTABLE bool toggleHold(const QString &handlerId, int times, int interval);
+    Q_SCRIPTABLE bool mergeAll();
+
+    Q_SCRIPTABLE void startLoad(const QVariantMap &profile);
+    Q_SCRIPTABLE void stopLoad();
+    Q_SCRIPTABLE bool runScript(const QString &script);
+
+    Q_SCRIPTABLE QVariantMap statistics() const;
+
+protected Q_SLOTS:
+    void onLoadTimeout();
+    void onScriptStep();
+
+private:
+    class SyntheticVoiceCallProviderPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(SyntheticVoiceCallProvider)
+};
+
+#endif // SYNTHETICVOICECALLPROVIDER_H
@@ -0,0 +1,131 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#include "common.h"
+#include "syntheticvoicecallproviderfactory.h"
+#include "syntheticvoicecallprovider.h"
+
+#include <voicecallmanagerinterface.h>
+
+#include <QDBusConnection>
+#include <QtPlugin>
+
+#define SYNTHETIC_OBJECT_PATH "/synthetic"
+
+class SyntheticVoiceCallProviderFactoryPrivate
+{
+    Q_DECLARE_PUBLIC(SyntheticVoiceCallProviderFactory)
+
+public:
+    SyntheticVoiceCallProviderFactoryPrivate(SyntheticVoiceCallProviderFactory *q)
+        : q_ptr(q), manager(NULL), provider(NULL)
+    {/* ... */}
+
+    SyntheticVoiceCallProviderFactory *q_ptr;
+
+    VoiceCallManagerInterface *manager;
+
+    SyntheticVoiceCallProvider *provider;
+};
+
+/*!
+  \class SyntheticVoiceCallProviderFactory
+  \brief Provides a SyntheticVoiceCallProvider, controlled over the
+         session bus at /synthetic.
+
+  Not built by default, see CONFIG+=enable-synthetic in providers.pro.
+*/
+SyntheticVoiceCallProviderFactory::SyntheticVoiceCallProviderFactory(QObject *parent)
+    : AbstractVoiceCallManagerPlugin(parent), d_ptr(new SyntheticVoiceCallProviderFactoryPrivate(this))
+{
+    TRACE
+}
+
+SyntheticVoiceCallProviderFactory::~SyntheticVoiceCallProviderFactory()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProviderFactory);
+    delete d;
+}
+
+QString SyntheticVoiceCallProviderFactory::pluginId() const
+{
+    TRACE
+    return PLUGIN_NAME;
+}
+
+bool SyntheticVoiceCallProviderFactory::initialize()
+{
+    TRACE
+    return true;
+}
+
+bool SyntheticVoiceCallProviderFactory::configure(VoiceCallManagerInterface *manager)
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProviderFactory);
+    if (d->provider) {
+        WARNING_T("SyntheticVoiceCallProviderFactory is already configured!");
+        return false;
+    }
+
+    d->manager = manager;
+    d->provider = new SyntheticVoiceCallProvider(manager, this);
+    d->manager->appendProvider(d->provider);
+
+    if (!QDBusConnection::sessionBus().registerObject(SYNTHETIC_OBJECT_PATH, d->provider,
+                                                      QDBusConnection::ExportScriptableSlots)) {
+        WARNING_T("Failed to register synthetic provider control object: %s",
+                  qPrintable(QDBusConnection::sessionBus().lastError().message()));
+    }
+    return true;
+}
+
+bool SyntheticVoiceCallProviderFactory::start()
+{
+    TRACE
+    return true;
+}
+
+bool SyntheticVoiceCallProviderFactory::suspend()
+{
+    TRACE
+    return true;
+}
+
+bool SyntheticVoiceCallProviderFactory::resume()
+{
+    TRACE
+    return true;
+}
+
+void SyntheticVoiceCallProviderFactory::finalize()
+{
+    TRACE
+    Q_D(SyntheticVoiceCallProviderFactory);
+    if (!d->provider)
+        return;
+
+    QDBusConnection::sessionBus().unregisterObject(SYNTHETIC_OBJECT_PATH);
+    d->provider->stopLoad();
+    d->manager->removeProvider(d->provider);
+    d->provider->deleteLater();
+    d->provider = NULL;
+}
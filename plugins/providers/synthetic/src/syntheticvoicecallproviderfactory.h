@@ -0,0 +1,51 @@
+/*
+ * This file is a part of the Voice Call Manager Synthetic Plugin project.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+#ifndef SYNTHETICVOICECALLPROVIDERFACTORY_H
+#define SYNTHETICVOICECALLPROVIDERFACTORY_H
+
+#include <abstractvoicecallmanagerplugin.h>
+
+class SyntheticVoiceCallProviderFactory : public AbstractVoiceCallManagerPlugin
+{
+    Q_OBJECT
+    Q_INTERFACES(AbstractVoiceCallManagerPlugin)
+    Q_PLUGIN_METADATA(IID "org.nemomobile.voicecall.synthetic")
+public:
+    explicit SyntheticVoiceCallProviderFactory(QObject *parent = 0);
+    ~SyntheticVoiceCallProviderFactory();
+
+    QString pluginId() const;
+
+public Q_SLOTS:
+    bool initialize();
+    bool configure(VoiceCallManagerInterface *manager);
+    bool start();
+    bool suspend();
+    bool resume();
+    void finalize();
+
+private:
+    class SyntheticVoiceCallProviderFactoryPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(SyntheticVoiceCallProviderFactory)
+};
+
+#endif // SYNTHETICVOICECALLPROVIDERFACTORY_H
@@ -260,15 +260,24 @@ void TelepathyProvider::createHandler(Tp::ChannelPtr ch, const QDateTime &userAc
     DEBUG_T("\tProcessing channel: %s", qPrintable(ch->objectPath()));
 
     Tp::CallChannelPtr callChannel = Tp::CallChannelPtr::dynamicCast(ch);
+    Tp::StreamedMediaChannelPtr streamChannel = Tp::StreamedMediaChannelPtr::dynamicCast(ch);
+    if (callChannel.isNull() && streamChannel.isNull())
+        return;
+
+    // Channels handed over again after a restart of the manager keep
+    // the id and start time of their call.
+    const VoiceCallManagerInterface::ReclaimedVoiceCall reclaimed = d->manager->reclaimVoiceCall(providerId(), ch->objectPath(),
+                                                                                                 ch->targetId(), QDateTime());
+    const QDateTime startedAt = reclaimed.startedAt.isValid() ? reclaimed.startedAt : userActionTime;
+
     if (callChannel && !callChannel.isNull()) {
         DEBUG_T("Found CallChannel interface.");
-        handler = new CallChannelHandler(d->manager->generateHandlerId(), callChannel, userActionTime, this);
+        handler = new CallChannelHandler(reclaimed.handlerId, callChannel, startedAt, this);
     }
 
-    Tp::StreamedMediaChannelPtr streamChannel = Tp::StreamedMediaChannelPtr::dynamicCast(ch);
     if (streamChannel && !streamChannel.isNull()) {
         DEBUG_T("Found StreamedMediaChannel interface.");
-        handler = new StreamChannelHandler(d->manager->generateHandlerId(), streamChannel, userActionTime, this);
+        handler = new StreamChannelHandler(reclaimed.handlerId, streamChannel, startedAt, this);
 
         connect(handler, &BaseChannelHandler::channelMerged, this, &TelepathyProvider::onChannelMerged);
         connect(handler, &BaseChannelHandler::channelRemoved, this, &TelepathyProvider::onChannelRemoved);
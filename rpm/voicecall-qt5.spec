@@ -127,6 +127,7 @@ fi
 %{_libdir}/qt5/qml/org/nemomobile/voicecall/libvoicecall.so
 %{_libdir}/qt5/qml/org/nemomobile/voicecall/qmldir
 %{_bindir}/voicecall-manager
+%{_bindir}/voicecall-trace
 %dir %{_libdir}/voicecall
 %dir %{_libdir}/voicecall/plugins
 %{_libdir}/voicecall/plugins/libvoicecall-playback-manager-plugin.so
@@ -159,4 +160,6 @@ fi
 
 %files tests
 /opt/tests/voicecall/filter
+/opt/tests/voicecall/commhistory
+/opt/tests/voicecall/manager
 
@@ -22,9 +22,12 @@
 #include "basicvoicecallconfigurator.h"
 
 #include "dbus/voicecallmanagerdbusservice.h"
+#include "voicecallapplication.h"
 
 #include <QDir>
+#include <QJsonObject>
 #include <QPluginLoader>
+#include <QThread>
 
 class BasicVoiceCallConfiguratorPrivate
 {
@@ -35,11 +38,58 @@ public:
         : q_ptr(q), manager(NULL)
     {/* ... */}
 
+    // A plugin with its own thread, and the probe of its event loop.
+    struct Worker {
+        QThread *thread;
+        EventLoopProbe *probe;
+    };
+
+    void startWorker(AbstractVoiceCallManagerPlugin *plugin)
+    {
+        Worker worker;
+        worker.thread = new QThread;
+        worker.thread->setObjectName(plugin->pluginId());
+        worker.probe = new EventLoopProbe(plugin->pluginId());
+        worker.probe->moveToThread(worker.thread);
+        plugin->moveToThread(worker.thread);
+        worker.thread->start();
+        workers.insert(plugin->pluginId(), worker);
+        if (VoiceCallApplication::instance())
+            VoiceCallApplication::instance()->addProbe(worker.probe);
+    }
+
+    void stopWorker(const QString &pluginId)
+    {
+        if (!workers.contains(pluginId))
+            return;
+
+        Worker worker = workers.take(pluginId);
+        if (VoiceCallApplication::instance())
+            VoiceCallApplication::instance()->removeProbe(worker.probe);
+        worker.thread->quit();
+        worker.thread->wait();
+        delete worker.probe;
+        delete worker.thread;
+    }
+
+    // Runs a slot of the plugin in its thread.
+    template <typename... Args>
+    static bool invoke(AbstractVoiceCallManagerPlugin *plugin, const char *method, Args... args)
+    {
+        VoiceCallApplication::Scope scope(method, plugin->pluginId());
+        bool result = false;
+        const Qt::ConnectionType type = plugin->thread() == QThread::currentThread()
+                ? Qt::DirectConnection : Qt::BlockingQueuedConnection;
+        QMetaObject::invokeMethod(plugin, method, type, Q_RETURN_ARG(bool, result), args...);
+        return result;
+    }
+
     BasicVoiceCallConfigurator *q_ptr;
 
     VoiceCallManagerInterface *manager;
 
     QHash<QString,AbstractVoiceCallManagerPlugin*> plugins;
+    QHash<QString, Worker> workers;
 };
 
 BasicVoiceCallConfigurator::BasicVoiceCallConfigurator(QObject *parent)
@@ -52,6 +102,13 @@ BasicVoiceCallConfigurator::~BasicVoiceCallConfigurator()
 {
     TRACE
     Q_D(BasicVoiceCallConfigurator);
+    // Plugins in their own thread are finalized there before it stops.
+    foreach (const QString &pluginId, d->workers.keys()) {
+        if (AbstractVoiceCallManagerPlugin *plugin = d->plugins.value(pluginId))
+            removePlugin(plugin);
+        else
+            d->stopWorker(pluginId);
+    }
     delete d;
 }
 
@@ -60,6 +117,7 @@ bool BasicVoiceCallConfigurator::configure(VoiceCallManagerInterface *manager)
     TRACE
     Q_D(BasicVoiceCallConfigurator);
     d->manager = manager;
+    qRegisterMetaType<VoiceCallManagerInterface*>();
 
     // Install statically linked plugins.
     VoiceCallManagerDBusService *srv = new VoiceCallManagerDBusService(this);
@@ -76,7 +134,11 @@ bool BasicVoiceCallConfigurator::configure(VoiceCallManagerInterface *manager)
         DEBUG_T("Attempting to load dynamic plugin: %s", qPrintable(pluginPath.absoluteFilePath(plugin)));
 
         QPluginLoader loader(pluginPath.absoluteFilePath(plugin));
-        QObject *instance = loader.instance();
+        QObject *instance = NULL;
+        {
+            VoiceCallApplication::Scope scope("load", plugin);
+            instance = loader.instance();
+        }
         AbstractVoiceCallManagerPlugin *managerPlugin = NULL;
 
         if (!instance) {
@@ -93,8 +155,18 @@ bool BasicVoiceCallConfigurator::configure(VoiceCallManagerInterface *manager)
             continue;
         }
 
+        // Plugins may ask for a thread of their own, their slots are then
+        // called through queued connections.
+        const QJsonObject metaData = loader.metaData().value(QStringLiteral("MetaData")).toObject();
+        if (metaData.value(QStringLiteral("threadAffinity")).toString() == QLatin1String("worker")
+                && !d->plugins.contains(managerPlugin->pluginId())) {
+            DEBUG_T("Running plugin %s in its own thread", qPrintable(managerPlugin->pluginId()));
+            d->startWorker(managerPlugin);
+        }
+
         if (!this->installPlugin(managerPlugin)) {
             WARNING_T("Plugin configuration failed");
+            d->stopWorker(managerPlugin->pluginId());
             delete managerPlugin;
             loader.unload();
             continue;
@@ -117,10 +189,11 @@ bool BasicVoiceCallConfigurator::installPlugin(AbstractVoiceCallManagerPlugin *p
 
     d->plugins.insert(plugin->pluginId(), plugin);
 
-    plugin->initialize();
-    if (!plugin->configure(d->manager))
+    BasicVoiceCallConfiguratorPrivate::invoke(plugin, "initialize");
+    if (!BasicVoiceCallConfiguratorPrivate::invoke(plugin, "configure",
+                                                   Q_ARG(VoiceCallManagerInterface*, d->manager)))
         return false;
-    plugin->start();
+    BasicVoiceCallConfiguratorPrivate::invoke(plugin, "start");
     return true;
 }
 
@@ -131,9 +204,13 @@ void BasicVoiceCallConfigurator::removePlugin(AbstractVoiceCallManagerPlugin *pl
     if (!d->plugins.contains(plugin->pluginId()))
         return;
 
-    plugin->suspend();
-    plugin->finalize();
+    BasicVoiceCallConfiguratorPrivate::invoke(plugin, "suspend");
+    QMetaObject::invokeMethod(plugin, "finalize", plugin->thread() == QThread::currentThread()
+                              ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
 
-    d->plugins.remove(plugin->pluginId());
+    const QString pluginId = plugin->pluginId();
+    d->plugins.remove(pluginId);
+    // Deleted in its thread, before that one finishes.
     plugin->deleteLater();
+    d->stopWorker(pluginId);
 }
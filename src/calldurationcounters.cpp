@@ -0,0 +1,331 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "common.h"
+#include "calldurationcounters.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTimer>
+
+namespace {
+
+const int Version = 1;
+// Coalesces the writes of calls ending close to each other.
+const int WriteDelay = 2000;
+const int KeptDays = 90;
+
+struct Bucket {
+    qint64 incoming = 0;
+    qint64 outgoing = 0;
+
+    QJsonObject toJson() const
+    {
+        QJsonObject object;
+        object.insert(QStringLiteral("incoming"), incoming);
+        object.insert(QStringLiteral("outgoing"), outgoing);
+        return object;
+    }
+
+    static Bucket fromJson(const QJsonObject &object)
+    {
+        Bucket bucket;
+        bucket.incoming = qint64(object.value(QStringLiteral("incoming")).toDouble());
+        bucket.outgoing = qint64(object.value(QStringLiteral("outgoing")).toDouble());
+        return bucket;
+    }
+};
+
+}
+
+/*!
+  \class CallDurationCounters
+  \brief Cumulated call durations, kept in memory and written behind.
+
+  Counters are loaded once, from a JSON file in the application data
+  directory, and saved atomically a short while after they change.
+  Besides the totals, durations are bucketed per provider and per day,
+  days older than three months being dropped.
+  A file that cannot be read, being corrupt or written by a newer
+  version, is moved aside and counting starts again.
+
+  The file is laid out as:
+  \code
+  {
+      "version": 1,
+      "total": { "incoming": 120, "outgoing": 300 },
+      "providers": { "<provider id>": { "incoming": 120, "outgoing": 300 } },
+      "days": { "2026-10-17": { "incoming": 120, "outgoing": 300 } }
+  }
+  \endcode
+*/
+class CallDurationCountersPrivate
+{
+    Q_DECLARE_PUBLIC(CallDurationCounters)
+
+public:
+    CallDurationCountersPrivate(CallDurationCounters *q, const QString &fileName)
+        : q_ptr(q), fileName(fileName)
+    {/* ... */}
+
+    void load();
+    void moveAside(const QString &suffix);
+    void migrate();
+    void schedule();
+
+    CallDurationCounters *q_ptr;
+
+    QString fileName;
+    Bucket total;
+    QHash<QString, Bucket> providers;
+    QMap<QDate, Bucket> days;
+
+    QTimer writeTimer;
+    bool readOnly = false; // Set when the file could not be kept.
+};
+
+void CallDurationCountersPrivate::load()
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        migrate();
+        return;
+    }
+
+    QJsonParseError error;
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll(), &error).object();
+    file.close();
+    if (error.error != QJsonParseError::NoError) {
+        WARNING_T("Invalid call duration counters %s: %s", qPrintable(fileName),
+                  qPrintable(error.errorString()));
+        moveAside(QStringLiteral(".corrupt"));
+        return;
+    }
+    // Written by a newer manager, kept for it rather than overwritten.
+    const int version = root.value(QStringLiteral("version")).toInt();
+    if (version > Version) {
+        WARNING_T("Unsupported call duration counters version %d in %s", version, qPrintable(fileName));
+        moveAside(QStringLiteral(".v%1").arg(version));
+        return;
+    }
+
+    total = Bucket::fromJson(root.value(QStringLiteral("total")).toObject());
+
+    const QJsonObject providerBuckets = root.value(QStringLiteral("providers")).toObject();
+    for (QJsonObject::const_iterator it = providerBuckets.constBegin();
+         it != providerBuckets.constEnd(); ++it) {
+        providers.insert(it.key(), Bucket::fromJson(it.value().toObject()));
+    }
+
+    const QJsonObject dayBuckets = root.value(QStringLiteral("days")).toObject();
+    for (QJsonObject::const_iterator it = dayBuckets.constBegin();
+         it != dayBuckets.constEnd(); ++it) {
+        const QDate day = QDate::fromString(it.key(), Qt::ISODate);
+        if (day.isValid()) {
+            days.insert(day, Bucket::fromJson(it.value().toObject()));
+        }
+    }
+}
+
+// Kept aside for recovery, counting starts again from zero.
+void CallDurationCountersPrivate::moveAside(const QString &suffix)
+{
+    const QString aside = fileName + suffix;
+    QFile::remove(aside);
+    if (QFile::rename(fileName, aside)) {
+        WARNING_T("Moved %s to %s", qPrintable(fileName), qPrintable(aside));
+    } else {
+        WARNING_T("Failed to move %s aside, counters will not be written", qPrintable(fileName));
+        readOnly = true;
+    }
+}
+
+// Counters used to live in QSettings, take them over once.
+void CallDurationCountersPrivate::migrate()
+{
+    QSettings settings;
+    if (!settings.childGroups().contains(QLatin1String("Voice Counters")))
+        return;
+
+    settings.beginGroup(QLatin1String("Voice Counters"));
+    total.incoming = settings.value(QLatin1String("Received")).toLongLong();
+    total.outgoing = settings.value(QLatin1String("Dialled")).toLongLong();
+    settings.endGroup();
+    DEBUG_T("Migrating call duration counters from %s", qPrintable(settings.fileName()));
+
+    Q_Q(CallDurationCounters);
+    q->flush();
+    if (QFile::exists(fileName))
+        settings.remove(QLatin1String("Voice Counters"));
+}
+
+void CallDurationCountersPrivate::schedule()
+{
+    if (!writeTimer.isActive())
+        writeTimer.start();
+}
+
+CallDurationCounters::CallDurationCounters(QObject *parent)
+    : CallDurationCounters(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                           + QStringLiteral("/counters.json"), parent)
+{
+}
+
+CallDurationCounters::CallDurationCounters(const QString &fileName, QObject *parent)
+    : QObject(parent), d_ptr(new CallDurationCountersPrivate(this, fileName))
+{
+    TRACE
+    Q_D(CallDurationCounters);
+    d->writeTimer.setSingleShot(true);
+    d->writeTimer.setInterval(WriteDelay);
+    QObject::connect(&d->writeTimer, SIGNAL(timeout()), this, SLOT(flush()));
+    d->load();
+}
+
+CallDurationCounters::~CallDurationCounters()
+{
+    TRACE
+    Q_D(CallDurationCounters);
+    if (d->writeTimer.isActive())
+        flush();
+    delete d;
+}
+
+QString CallDurationCounters::fileName() const
+{
+    Q_D(const CallDurationCounters);
+    return d->fileName;
+}
+
+int CallDurationCounters::incoming() const
+{
+    Q_D(const CallDurationCounters);
+    return d->total.incoming;
+}
+
+int CallDurationCounters::outgoing() const
+{
+    Q_D(const CallDurationCounters);
+    return d->total.outgoing;
+}
+
+int CallDurationCounters::incoming(const QString &providerId) const
+{
+    Q_D(const CallDurationCounters);
+    return d->providers.value(providerId).incoming;
+}
+
+int CallDurationCounters::outgoing(const QString &providerId) const
+{
+    Q_D(const CallDurationCounters);
+    return d->providers.value(providerId).outgoing;
+}
+
+int CallDurationCounters::incoming(const QDate &day) const
+{
+    Q_D(const CallDurationCounters);
+    return d->days.value(day).incoming;
+}
+
+int CallDurationCounters::outgoing(const QDate &day) const
+{
+    Q_D(const CallDurationCounters);
+    return d->days.value(day).outgoing;
+}
+
+/*!
+  Adds \a seconds to the counters of \a providerId and \a day, the
+  change is written out shortly after.
+*/
+void CallDurationCounters::add(const QString &providerId, bool incoming, int seconds, const QDate &day)
+{
+    TRACE
+    Q_D(CallDurationCounters);
+    Bucket *buckets[] = { &d->total, &d->providers[providerId], &d->days[day] };
+    for (Bucket *bucket : buckets) {
+        (incoming ? bucket->incoming : bucket->outgoing) += seconds;
+    }
+
+    while (!d->days.isEmpty() && d->days.firstKey() < day.addDays(-KeptDays))
+        d->days.erase(d->days.begin());
+
+    d->schedule();
+}
+
+void CallDurationCounters::reset()
+{
+    TRACE
+    Q_D(CallDurationCounters);
+    d->total = Bucket();
+    d->providers.clear();
+    d->days.clear();
+    d->schedule();
+}
+
+/*!
+  Writes the counters now, replacing the file atomically.
+*/
+void CallDurationCounters::flush()
+{
+    TRACE
+    Q_D(CallDurationCounters);
+    d->writeTimer.stop();
+    if (d->readOnly)
+        return;
+
+    QJsonObject providers;
+    for (QHash<QString, Bucket>::const_iterator it = d->providers.constBegin();
+         it != d->providers.constEnd(); ++it) {
+        providers.insert(it.key(), it.value().toJson());
+    }
+    QJsonObject days;
+    for (QMap<QDate, Bucket>::const_iterator it = d->days.constBegin();
+         it != d->days.constEnd(); ++it) {
+        days.insert(it.key().toString(Qt::ISODate), it.value().toJson());
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), Version);
+    root.insert(QStringLiteral("total"), d->total.toJson());
+    root.insert(QStringLiteral("providers"), providers);
+    root.insert(QStringLiteral("days"), days);
+
+    QDir().mkpath(QFileInfo(d->fileName).absolutePath());
+    QSaveFile file(d->fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        WARNING_T("Failed to write call duration counters %s: %s", qPrintable(d->fileName),
+                  qPrintable(file.errorString()));
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        WARNING_T("Failed to write call duration counters %s: %s", qPrintable(d->fileName),
+                  qPrintable(file.errorString()));
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CALLDURATIONCOUNTERS_H
+#define CALLDURATIONCOUNTERS_H
+
+#include <QDate>
+#include <QObject>
+
+class CallDurationCounters : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CallDurationCounters(QObject *parent = 0);
+    explicit CallDurationCounters(const QString &fileName, QObject *parent = 0);
+    ~CallDurationCounters();
+
+    QString fileName() const;
+
+    int incoming() const;
+    int outgoing() const;
+    int incoming(const QString &providerId) const;
+    int outgoing(const QString &providerId) const;
+    int incoming(const QDate &day) const;
+    int outgoing(const QDate &day) const;
+
+    void add(const QString &providerId, bool incoming, int seconds,
+             const QDate &day = QDate::currentDate());
+    void reset();
+
+public Q_SLOTS:
+    void flush();
+
+private:
+    class CallDurationCountersPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(CallDurationCounters)
+};
+
+#endif // CALLDURATIONCOUNTERS_H
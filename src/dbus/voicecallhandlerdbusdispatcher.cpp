@@ -0,0 +1,743 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+#include "common.h"
+#include "voicecallhandlerdbusdispatcher.h"
+
+#include <abstractvoicecallprovider.h>
+#include <voicecallhandlerid.h>
+#include <voicecallmanagerinterface.h>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusServiceWatcher>
+#include <QDBusVariant>
+#include <QTimer>
+
+#include <ctime>
+
+namespace {
+
+const char *const VoiceCallInterface = "org.nemomobile.voicecall.VoiceCall";
+const char *const PropertiesInterface = "org.freedesktop.DBus.Properties";
+const char *const CallsPath = "/calls";
+const char *const CallPathPrefix = "/calls/";
+const char *const ActiveCallPath = "/calls/active";
+
+// Durations change once a second at most.
+const int MinDurationInterval = 1000;
+
+// The org.nemomobile.voicecall.VoiceCall interface, as served for every call.
+const char IntrospectionXml[] =
+    "  <interface name=\"org.nemomobile.voicecall.VoiceCall\">\n"
+    "    <property name=\"handlerId\" type=\"s\" access=\"read\"/>\n"
+    "    <property name=\"providerId\" type=\"s\" access=\"read\"/>\n"
+    "    <property name=\"status\" type=\"i\" access=\"read\"/>\n"
+    "    <property name=\"statusText\" type=\"s\" access=\"read\"/>\n"
+    "    <property name=\"lineId\" type=\"s\" access=\"read\"/>\n"
+    "    <property name=\"startedAt\" type=\"x\" access=\"read\"/>\n"
+    "    <property name=\"startedAtMonotonic\" type=\"x\" access=\"read\"/>\n"
+    "    <property name=\"duration\" type=\"i\" access=\"read\"/>\n"
+    "    <property name=\"isIncoming\" type=\"b\" access=\"read\"/>\n"
+    "    <property name=\"isEmergency\" type=\"b\" access=\"read\"/>\n"
+    "    <property name=\"isMultiparty\" type=\"b\" access=\"read\"/>\n"
+    "    <property name=\"isForwarded\" type=\"b\" access=\"read\"/>\n"
+    "    <property name=\"isRemoteHeld\" type=\"b\" access=\"read\"/>\n"
+    "    <property name=\"parentHandlerId\" type=\"s\" access=\"read\"/>\n"
+    "    <property name=\"childCalls\" type=\"as\" access=\"read\"/>\n"
+    "    <signal name=\"error\">\n"
+    "      <arg name=\"message\" type=\"s\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"statusChanged\">\n"
+    "      <arg type=\"i\"/>\n"
+    "      <arg type=\"s\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"lineIdChanged\">\n"
+    "      <arg type=\"s\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"startedAtChanged\">\n"
+    "      <arg type=\"((iii)(iiii)i)\"/>\n"
+    "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"QDateTime\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"durationChanged\">\n"
+    "      <arg type=\"i\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"emergencyChanged\">\n"
+    "      <arg type=\"b\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"multipartyChanged\">\n"
+    "      <arg type=\"b\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"forwardedChanged\">\n"
+    "      <arg type=\"b\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"remoteHeldChanged\">\n"
+    "      <arg type=\"b\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"parentHandlerIdChanged\">\n"
+    "      <arg type=\"s\"/>\n"
+    "    </signal>\n"
+    "    <signal name=\"childCallsChanged\">\n"
+    "      <arg type=\"as\"/>\n"
+    "    </signal>\n"
+    "    <method name=\"answer\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "    </method>\n"
+    "    <method name=\"hangup\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "    </method>\n"
+    "    <method name=\"filter\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "      <arg name=\"action\" type=\"(i)\" direction=\"in\"/>\n"
+    "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"AbstractVoiceCallHandler::VoiceCallFilterAction\"/>\n"
+    "    </method>\n"
+    "    <method name=\"hold\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "      <arg name=\"on\" type=\"b\" direction=\"in\"/>\n"
+    "    </method>\n"
+    "    <method name=\"deflect\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "      <arg name=\"target\" type=\"s\" direction=\"in\"/>\n"
+    "    </method>\n"
+    "    <method name=\"sendDtmf\">\n"
+    "      <arg name=\"tones\" type=\"s\" direction=\"in\"/>\n"
+    "    </method>\n"
+    "    <method name=\"merge\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "      <arg name=\"callHandle\" type=\"s\" direction=\"in\"/>\n"
+    "    </method>\n"
+    "    <method name=\"split\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "    </method>\n"
+    "    <method name=\"subscribeDuration\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "      <arg name=\"interval\" type=\"i\" direction=\"in\"/>\n"
+    "    </method>\n"
+    "    <method name=\"unsubscribeDuration\">\n"
+    "      <arg type=\"b\" direction=\"out\"/>\n"
+    "    </method>\n"
+    "    <method name=\"getProperties\">\n"
+    "      <arg type=\"a{sv}\" direction=\"out\"/>\n"
+    "      <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"QVariantMap\"/>\n"
+    "    </method>\n"
+    "  </interface>\n";
+
+qint64 monotonicNow()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+// The names of the properties standing for the changed ones.
+QStringList propertyNames(VoiceCallChangeSet::Properties changed)
+{
+    QStringList result;
+    if (changed & VoiceCallChangeSet::PROPERTY_STATUS)
+        result << "status" << "statusText";
+    if (changed & VoiceCallChangeSet::PROPERTY_LINE_ID)
+        result << "lineId";
+    if (changed & VoiceCallChangeSet::PROPERTY_STARTED_AT)
+        result << "startedAt" << "startedAtMonotonic";
+    if (changed & VoiceCallChangeSet::PROPERTY_DURATION)
+        result << "duration";
+    if (changed & VoiceCallChangeSet::PROPERTY_EMERGENCY)
+        result << "isEmergency";
+    if (changed & VoiceCallChangeSet::PROPERTY_MULTIPARTY)
+        result << "isMultiparty";
+    if (changed & VoiceCallChangeSet::PROPERTY_FORWARDED)
+        result << "isForwarded";
+    if (changed & VoiceCallChangeSet::PROPERTY_REMOTE_HELD)
+        result << "isRemoteHeld";
+    if (changed & VoiceCallChangeSet::PROPERTY_PARENT_HANDLER_ID)
+        result << "parentHandlerId";
+    if (changed & VoiceCallChangeSet::PROPERTY_CHILD_CALLS)
+        result << "childCalls";
+    return result;
+}
+
+QStringList childCallIds(const AbstractVoiceCallHandler *handler)
+{
+    QStringList result;
+    if (handler) {
+        foreach (AbstractVoiceCallHandler *child, handler->childCalls())
+            result.append(child->handlerId());
+    }
+    return result;
+}
+
+}
+
+/*!
+  \class VoiceCallHandlerDBusDispatcher
+  \brief Serves the org.nemomobile.voicecall.VoiceCall objects of all
+         calls, at /calls/<id> and /calls/active.
+
+  Registered once as a virtual object over the /calls subtree, calls
+  are looked up in the manager as messages come in. Nothing is set up
+  on the bus as calls come and go, and the introspection data is the
+  same for every call. Changes are signalled from the change sets of
+  the manager, see publish().
+
+  Durations are not broadcast. Clients either count from
+  startedAtMonotonic, the start of the call on CLOCK_MONOTONIC in ms,
+  or call subscribeDuration() on the object of a call to get its
+  duration in PropertiesChanged signals sent to them only, at the
+  interval of their choice. A subscription to /calls/active carries
+  over to the next active call, and is idle while there is none.
+
+  The properties of each call are kept, those changed being read again
+  from the handler once the change set is in. getProperties(),
+  Properties.GetAll, the object manager and PropertiesChanged all
+  share the same map.
+*/
+class VoiceCallHandlerDBusDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(VoiceCallHandlerDBusDispatcher)
+
+public:
+    VoiceCallHandlerDBusDispatcherPrivate(VoiceCallHandlerDBusDispatcher *q, VoiceCallManagerInterface *pManager)
+        : q_ptr(q), manager(pManager), legacySignals(false),
+          watcher(QString(), QDBusConnection::sessionBus(), QDBusServiceWatcher::WatchForUnregistration)
+    {/*...*/}
+
+    struct CachedProperties {
+        QVariantMap values;
+        VoiceCallChangeSet::Properties stale;
+    };
+
+    void update(const AbstractVoiceCallHandler *handler, VoiceCallChangeSet::Properties which,
+                QVariantMap *values) const;
+
+    struct Subscription {
+        QString service;
+        QString path;
+        QTimer *timer;
+        int interval;
+        int duration;
+    };
+
+    AbstractVoiceCallHandler *handler(const QString &path) const;
+
+    void invoke(AbstractVoiceCallHandler *handler, const QDBusMessage &message, const QDBusConnection &connection);
+    void accessProperties(AbstractVoiceCallHandler *handler, const QDBusMessage &message, const QDBusConnection &connection);
+
+    qint64 startedAtMonotonic(const QString &handlerId, const QDateTime &startedAt) const;
+
+    void subscribe(const QString &service, const QString &path, int interval);
+    void unsubscribe(const QString &service, const QString &path);
+    void sendDuration(const QString &key);
+    void activeVoiceCallChanged(bool hasActive);
+
+    void emitChanges(const QString &path, VoiceCallChangeSet::Properties changed,
+                     const QVariantMap &properties, const VoiceCallSnapshot &snapshot,
+                     const QStringList &childCalls);
+    void emitLegacySignals(const QString &path, VoiceCallChangeSet::Properties changed,
+                           const VoiceCallSnapshot &snapshot, const QStringList &childCalls);
+
+    VoiceCallHandlerDBusDispatcher *q_ptr;
+    VoiceCallManagerInterface *manager;
+    bool legacySignals;
+
+    // Keyed by subscriber and path.
+    QHash<QString, Subscription> subscriptions;
+    QDBusServiceWatcher watcher;
+
+    mutable QHash<QString, qint64> monotonicStarts;
+    mutable QHash<QString, CachedProperties> cache;
+};
+
+AbstractVoiceCallHandler *VoiceCallHandlerDBusDispatcherPrivate::handler(const QString &path) const
+{
+    if (path == QLatin1String(ActiveCallPath))
+        return manager->activeVoiceCall();
+    if (!path.startsWith(QLatin1String(CallPathPrefix)))
+        return NULL;
+    return manager->voiceCall(path.mid(qstrlen(CallPathPrefix)));
+}
+
+/*
+  Taken once, so the wall clock being set during the call does not
+  move it.
+*/
+qint64 VoiceCallHandlerDBusDispatcherPrivate::startedAtMonotonic(const QString &handlerId,
+                                                                 const QDateTime &startedAt) const
+{
+    if (!startedAt.isValid())
+        return 0;
+
+    QHash<QString, qint64>::const_iterator it = monotonicStarts.constFind(handlerId);
+    if (it != monotonicStarts.constEnd())
+        return it.value();
+
+    const qint64 result = monotonicNow() - (QDateTime::currentMSecsSinceEpoch() - startedAt.toMSecsSinceEpoch());
+    monotonicStarts.insert(handlerId, result);
+    return result;
+}
+
+// Reads the properties standing for which from handler into values.
+void VoiceCallHandlerDBusDispatcherPrivate::update(const AbstractVoiceCallHandler *handler,
+                                                   VoiceCallChangeSet::Properties which,
+                                                   QVariantMap *values) const
+{
+    if (which & VoiceCallChangeSet::PROPERTY_STATUS) {
+        values->insert("status", QVariant(int(handler->status())));
+        values->insert("statusText", QVariant(handler->statusText()));
+    }
+    if (which & VoiceCallChangeSet::PROPERTY_LINE_ID)
+        values->insert("lineId", QVariant(handler->lineId()));
+    if (which & VoiceCallChangeSet::PROPERTY_STARTED_AT) {
+        const QDateTime startedAt = handler->startedAt();
+        values->insert("startedAt", QVariant(startedAt.toMSecsSinceEpoch()));
+        values->insert("startedAtMonotonic", QVariant(startedAtMonotonic(handler->handlerId(), startedAt)));
+    }
+    if (which & VoiceCallChangeSet::PROPERTY_DURATION)
+        values->insert("duration", QVariant(handler->duration()));
+    if (which & VoiceCallChangeSet::PROPERTY_EMERGENCY)
+        values->insert("isEmergency", QVariant(handler->isEmergency()));
+    if (which & VoiceCallChangeSet::PROPERTY_MULTIPARTY)
+        values->insert("isMultiparty", QVariant(handler->isMultiparty()));
+    if (which & VoiceCallChangeSet::PROPERTY_FORWARDED)
+        values->insert("isForwarded", QVariant(handler->isForwarded()));
+    if (which & VoiceCallChangeSet::PROPERTY_REMOTE_HELD)
+        values->insert("isRemoteHeld", QVariant(handler->isRemoteHeld()));
+    if (which & VoiceCallChangeSet::PROPERTY_PARENT_HANDLER_ID)
+        values->insert("parentHandlerId", QVariant(handler->parentHandlerId()));
+    if (which & VoiceCallChangeSet::PROPERTY_CHILD_CALLS)
+        values->insert("childCalls", QVariant(childCallIds(handler)));
+}
+
+void VoiceCallHandlerDBusDispatcherPrivate::subscribe(const QString &service, const QString &path, int interval)
+{
+    Q_Q(VoiceCallHandlerDBusDispatcher);
+    const QString key = service + QLatin1Char('\n') + path;
+
+    QHash<QString, Subscription>::iterator it = subscriptions.find(key);
+    if (it == subscriptions.end()) {
+        Subscription subscription;
+        subscription.service = service;
+        subscription.path = path;
+        subscription.timer = new QTimer(q);
+        subscription.interval = MinDurationInterval;
+        subscription.duration = -1;
+        QObject::connect(subscription.timer, &QTimer::timeout, q, [this, key] () { sendDuration(key); });
+        it = subscriptions.insert(key, subscription);
+        watcher.addWatchedService(service);
+    }
+    it->interval = qMax(interval, MinDurationInterval);
+    it->timer->start(it->interval);
+    sendDuration(key);
+}
+
+void VoiceCallHandlerDBusDispatcherPrivate::unsubscribe(const QString &service, const QString &path)
+{
+    for (QHash<QString, Subscription>::iterator it = subscriptions.begin(); it != subscriptions.end();) {
+        if (it->service == service && (path.isEmpty() || it->path == path)) {
+            delete it->timer;
+            it = subscriptions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    foreach (const Subscription &subscription, subscriptions) {
+        if (subscription.service == service)
+            return;
+    }
+    watcher.removeWatchedService(service);
+}
+
+void VoiceCallHandlerDBusDispatcherPrivate::sendDuration(const QString &key)
+{
+    QHash<QString, Subscription>::iterator it = subscriptions.find(key);
+    if (it == subscriptions.end())
+        return;
+
+    AbstractVoiceCallHandler *handler = this->handler(it->path);
+    if (!handler) {
+        // Left until there is an active call again, without waking up.
+        it->timer->stop();
+        return;
+    }
+    if (handler->duration() == it->duration)
+        return;
+    it->duration = handler->duration();
+
+    QVariantMap changed;
+    changed.insert("duration", it->duration);
+    QDBusConnection::sessionBus().send(
+                QDBusMessage::createTargetedSignal(it->service, it->path, QLatin1String(PropertiesInterface),
+                                                   QStringLiteral("PropertiesChanged"))
+                << QString::fromLatin1(VoiceCallInterface)
+                << changed
+                << QStringList());
+}
+
+/*
+  Subscriptions to /calls/active follow whichever call is active, and
+  only run while there is one.
+*/
+void VoiceCallHandlerDBusDispatcherPrivate::activeVoiceCallChanged(bool hasActive)
+{
+    for (QHash<QString, Subscription>::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it) {
+        if (it->path != QLatin1String(ActiveCallPath))
+            continue;
+        it->duration = -1;
+        if (hasActive) {
+            it->timer->start(it->interval);
+            sendDuration(it.key());
+        } else {
+            it->timer->stop();
+        }
+    }
+}
+
+void VoiceCallHandlerDBusDispatcherPrivate::invoke(AbstractVoiceCallHandler *handler,
+                                                   const QDBusMessage &message,
+                                                   const QDBusConnection &connection)
+{
+    const QString member = message.member();
+    const QString signature = message.signature();
+    const QVariantList arguments = message.arguments();
+    QVariantList results;
+
+    if (member == QLatin1String("answer") && signature.isEmpty()) {
+        manager->traceVoiceCallEvent(handler->handlerId(), QStringLiteral("answer"));
+        handler->answer();
+        results << true;
+    } else if (member == QLatin1String("hangup") && signature.isEmpty()) {
+        handler->hangup();
+        results << true;
+    } else if (member == QLatin1String("filter") && signature == QLatin1String("(i)")) {
+        handler->filter(qdbus_cast<AbstractVoiceCallHandler::VoiceCallFilterAction>(arguments.at(0)));
+        results << true;
+    } else if (member == QLatin1String("hold") && signature == QLatin1String("b")) {
+        handler->hold(arguments.at(0).toBool());
+        results << true;
+    } else if (member == QLatin1String("deflect") && signature == QLatin1String("s")) {
+        handler->deflect(arguments.at(0).toString());
+        results << true;
+    } else if (member == QLatin1String("sendDtmf") && signature == QLatin1String("s")) {
+        handler->sendDtmf(arguments.at(0).toString());
+    } else if (member == QLatin1String("merge") && signature == QLatin1String("s")) {
+        handler->merge(arguments.at(0).toString());
+        results << true;
+    } else if (member == QLatin1String("split") && signature.isEmpty()) {
+        handler->split();
+        results << true;
+    } else if (member == QLatin1String("subscribeDuration") && signature == QLatin1String("i")) {
+        subscribe(message.service(), message.path(), arguments.at(0).toInt());
+        results << true;
+    } else if (member == QLatin1String("unsubscribeDuration") && signature.isEmpty()) {
+        unsubscribe(message.service(), message.path());
+        results << true;
+    } else if (member == QLatin1String("getProperties") && signature.isEmpty()) {
+        results << q_ptr->properties(handler);
+    } else {
+        connection.send(message.createErrorReply(QDBusError::UnknownMethod,
+                                                 QStringLiteral("No such method %1(%2)").arg(member, signature)));
+        return;
+    }
+
+    if (message.isReplyRequired())
+        connection.send(message.createReply(results));
+}
+
+void VoiceCallHandlerDBusDispatcherPrivate::accessProperties(AbstractVoiceCallHandler *handler,
+                                                             const QDBusMessage &message,
+                                                             const QDBusConnection &connection)
+{
+    const QString member = message.member();
+    const QVariantList arguments = message.arguments();
+    const QString interface = arguments.value(0).toString();
+
+    if (!interface.isEmpty() && interface != QLatin1String(VoiceCallInterface)) {
+        connection.send(message.createErrorReply(QDBusError::UnknownInterface,
+                                                 QStringLiteral("No such interface %1").arg(interface)));
+        return;
+    }
+
+    const QVariantMap props = q_ptr->properties(handler);
+    if (member == QLatin1String("GetAll") && message.signature() == QLatin1String("s")) {
+        connection.send(message.createReply(props));
+    } else if (member == QLatin1String("Get") && message.signature() == QLatin1String("ss")) {
+        const QString name = arguments.at(1).toString();
+        if (props.contains(name))
+            connection.send(message.createReply(QVariant::fromValue(QDBusVariant(props.value(name)))));
+        else
+            connection.send(message.createErrorReply(QDBusError::UnknownProperty,
+                                                     QStringLiteral("No such property %1").arg(name)));
+    } else if (member == QLatin1String("Set")) {
+        connection.send(message.createErrorReply(QDBusError::PropertyReadOnly,
+                                                 QStringLiteral("Call properties are read only")));
+    } else {
+        connection.send(message.createErrorReply(QDBusError::UnknownMethod,
+                                                 QStringLiteral("No such method %1").arg(member)));
+    }
+}
+
+/*
+  All the changes of a call in one event loop turn make a single
+  PropertiesChanged signal, durations left to subscriptions.
+*/
+void VoiceCallHandlerDBusDispatcherPrivate::emitChanges(const QString &path,
+                                                        VoiceCallChangeSet::Properties changed,
+                                                        const QVariantMap &properties,
+                                                        const VoiceCallSnapshot &snapshot,
+                                                        const QStringList &childCalls)
+{
+    if (!properties.isEmpty()) {
+        QDBusConnection::sessionBus().send(
+                    QDBusMessage::createSignal(path, QLatin1String(PropertiesInterface), QStringLiteral("PropertiesChanged"))
+                    << QString::fromLatin1(VoiceCallInterface)
+                    << properties
+                    << QStringList());
+    }
+
+    // Still including durationChanged, as legacy clients expect.
+    if (legacySignals)
+        emitLegacySignals(path, changed, snapshot, childCalls);
+}
+
+// One signal per property, for clients not following PropertiesChanged.
+void VoiceCallHandlerDBusDispatcherPrivate::emitLegacySignals(const QString &path,
+                                                              VoiceCallChangeSet::Properties changed,
+                                                              const VoiceCallSnapshot &snapshot,
+                                                              const QStringList &childCalls)
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    const QString interface = QLatin1String(VoiceCallInterface);
+
+    if (changed & VoiceCallChangeSet::PROPERTY_STATUS)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("statusChanged"))
+                 << int(snapshot.status) << AbstractVoiceCallHandler::statusText(snapshot.status));
+    if (changed & VoiceCallChangeSet::PROPERTY_LINE_ID)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("lineIdChanged"))
+                 << snapshot.lineId);
+    if (changed & VoiceCallChangeSet::PROPERTY_STARTED_AT)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("startedAtChanged"))
+                 << snapshot.startedAt);
+    if (changed & VoiceCallChangeSet::PROPERTY_DURATION)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("durationChanged"))
+                 << snapshot.duration);
+    if (changed & VoiceCallChangeSet::PROPERTY_EMERGENCY)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("emergencyChanged"))
+                 << snapshot.isEmergency);
+    if (changed & VoiceCallChangeSet::PROPERTY_MULTIPARTY)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("multipartyChanged"))
+                 << snapshot.isMultiparty);
+    if (changed & VoiceCallChangeSet::PROPERTY_FORWARDED)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("forwardedChanged"))
+                 << snapshot.isForwarded);
+    if (changed & VoiceCallChangeSet::PROPERTY_REMOTE_HELD)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("remoteHeldChanged"))
+                 << snapshot.isRemoteHeld);
+    if (changed & VoiceCallChangeSet::PROPERTY_PARENT_HANDLER_ID)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("parentHandlerIdChanged"))
+                 << snapshot.parentHandlerId);
+    if (changed & VoiceCallChangeSet::PROPERTY_CHILD_CALLS)
+        bus.send(QDBusMessage::createSignal(path, interface, QStringLiteral("childCallsChanged"))
+                 << childCalls);
+}
+
+VoiceCallHandlerDBusDispatcher::VoiceCallHandlerDBusDispatcher(VoiceCallManagerInterface *manager, QObject *parent)
+    : QDBusVirtualObject(parent), d_ptr(new VoiceCallHandlerDBusDispatcherPrivate(this, manager))
+{
+    TRACE
+    Q_D(VoiceCallHandlerDBusDispatcher);
+    QObject::connect(&d->watcher, &QDBusServiceWatcher::serviceUnregistered,
+                     this, [d] (const QString &service) { d->unsubscribe(service, QString()); });
+}
+
+VoiceCallHandlerDBusDispatcher::~VoiceCallHandlerDBusDispatcher()
+{
+    TRACE
+    Q_D(VoiceCallHandlerDBusDispatcher);
+    delete d;
+}
+
+/*!
+  Whether the per property signals of the VoiceCall interface are sent
+  along with PropertiesChanged, see VoiceCallManager::legacySignals().
+*/
+void VoiceCallHandlerDBusDispatcher::setLegacySignals(bool on)
+{
+    TRACE
+    Q_D(VoiceCallHandlerDBusDispatcher);
+    d->legacySignals = on;
+}
+
+/*!
+  Returns the interfaces at \a path, QtDBus adding the standard ones.
+  The /calls node lists the calls as its children.
+*/
+QString VoiceCallHandlerDBusDispatcher::introspect(const QString &path) const
+{
+    TRACE
+    Q_D(const VoiceCallHandlerDBusDispatcher);
+    static const QString interfaces = QString::fromLatin1(IntrospectionXml);
+
+    if (path != QLatin1String(CallsPath))
+        return d->handler(path) ? interfaces : QString();
+
+    QString nodes;
+    foreach (AbstractVoiceCallHandler *handler, d->manager->voiceCalls())
+        nodes += QStringLiteral("  <node name=\"%1\"/>\n").arg(handler->handlerId());
+    if (d->manager->activeVoiceCall())
+        nodes += QStringLiteral("  <node name=\"active\"/>\n");
+    return nodes;
+}
+
+bool VoiceCallHandlerDBusDispatcher::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    TRACE
+    Q_D(VoiceCallHandlerDBusDispatcher);
+    const QString interface = message.interface();
+
+    // Introspection is left to QtDBus, see introspect().
+    if (interface == QLatin1String("org.freedesktop.DBus.Introspectable"))
+        return false;
+
+    AbstractVoiceCallHandler *handler = d->handler(message.path());
+    if (!handler) {
+        connection.send(message.createErrorReply(QDBusError::UnknownObject,
+                                                 QStringLiteral("No call at %1").arg(message.path())));
+        return true;
+    }
+
+    if (interface == QLatin1String(PropertiesInterface)) {
+        d->accessProperties(handler, message, connection);
+    } else if (interface.isEmpty() || interface == QLatin1String(VoiceCallInterface)) {
+        d->invoke(handler, message, connection);
+    } else {
+        connection.send(message.createErrorReply(QDBusError::UnknownInterface,
+                                                 QStringLiteral("No such interface %1").arg(interface)));
+    }
+    return true;
+}
+
+/*!
+  Signals the changes of \a changes on the objects of the calls. Calls
+  just added are left out, their state comes along with them.
+*/
+void VoiceCallHandlerDBusDispatcher::publish(const VoiceCallChangeSet &changes)
+{
+    TRACE
+    Q_D(VoiceCallHandlerDBusDispatcher);
+    AbstractVoiceCallHandler *active = d->manager->activeVoiceCall();
+
+    foreach (const QString &handlerId, changes.removed) {
+        d->monotonicStarts.remove(handlerId);
+        d->cache.remove(handlerId);
+        const VoiceCallHandlerId id = changes.id(handlerId);
+        if (id.isNull())
+            continue;
+        foreach (const VoiceCallHandlerDBusDispatcherPrivate::Subscription &subscription, d->subscriptions.values()) {
+            if (subscription.path == id.objectPath())
+                d->unsubscribe(subscription.service, subscription.path);
+        }
+    }
+
+    // Calls just added included, their properties may have been read.
+    for (QHash<QString, VoiceCallChangeSet::Properties>::const_iterator it = changes.changed.constBegin();
+         it != changes.changed.constEnd(); ++it) {
+        if (it.value() & VoiceCallChangeSet::PROPERTY_STARTED_AT)
+            d->monotonicStarts.remove(it.key());
+        QHash<QString, VoiceCallHandlerDBusDispatcherPrivate::CachedProperties>::iterator cached = d->cache.find(it.key());
+        if (cached != d->cache.end())
+            cached->stale |= it.value();
+    }
+
+    for (QHash<QString, VoiceCallChangeSet::Properties>::const_iterator it = changes.changed.constBegin();
+         it != changes.changed.constEnd(); ++it) {
+        QHash<QString, VoiceCallSnapshot>::const_iterator snapshot = changes.snapshots.constFind(it.key());
+        if (snapshot == changes.snapshots.constEnd() || changes.added.contains(it.key()))
+            continue;
+
+        const VoiceCallHandlerId &id = snapshot->id;
+        if (id.isNull())
+            continue;
+
+        // Removed calls are not listed as changed.
+        AbstractVoiceCallHandler *handler = d->manager->voiceCall(it.key());
+        if (!handler)
+            continue;
+
+        const VoiceCallChangeSet::Properties changed = it.value() & ~VoiceCallChangeSet::PROPERTY_DURATION;
+        const QStringList childCalls = it.value() & VoiceCallChangeSet::PROPERTY_CHILD_CALLS
+                ? childCallIds(handler) : QStringList();
+
+        QVariantMap values;
+        const QVariantMap all = properties(handler);
+        foreach (const QString &name, propertyNames(changed))
+            values.insert(name, all.value(name));
+
+        d->emitChanges(id.objectPath(), it.value(), values, snapshot.value(), childCalls);
+        if (active && active == handler)
+            d->emitChanges(QLatin1String(ActiveCallPath), it.value(), values, snapshot.value(), childCalls);
+    }
+
+    if (changes.activeVoiceCallChanged)
+        d->activeVoiceCallChanged(active != NULL);
+}
+
+/*!
+  Returns the properties of \a handler as published on the bus, by
+  getProperties() and the object manager.
+*/
+QVariantMap VoiceCallHandlerDBusDispatcher::properties(const AbstractVoiceCallHandler *handler) const
+{
+    TRACE
+    Q_D(const VoiceCallHandlerDBusDispatcher);
+    VoiceCallHandlerDBusDispatcherPrivate::CachedProperties &cached = d->cache[handler->handlerId()];
+
+    if (cached.values.isEmpty()) {
+        cached.values.insert("handlerId", QVariant(handler->handlerId()));
+        cached.values.insert("providerId", QVariant(handler->provider()->providerId()));
+        cached.values.insert("isIncoming", QVariant(handler->isIncoming()));
+        d->update(handler, VoiceCallChangeSet::PROPERTY_ALL, &cached.values);
+    } else if (cached.stale) {
+        d->update(handler, cached.stale, &cached.values);
+    }
+    cached.stale = VoiceCallChangeSet::Properties();
+
+    // Shared, not copied.
+    return cached.values;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, AbstractVoiceCallHandler::VoiceCallFilterAction action)
+{
+    int value = action;
+    argument.beginStructure();
+    argument << value;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, AbstractVoiceCallHandler::VoiceCallFilterAction &action)
+{
+    int value;
+    argument.beginStructure();
+    argument >> value;
+    argument.endStructure();
+    action = static_cast<AbstractVoiceCallHandler::VoiceCallFilterAction>(value);
+    return argument;
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+#ifndef VOICECALLHANDLERDBUSDISPATCHER_H
+#define VOICECALLHANDLERDBUSDISPATCHER_H
+
+#include <abstractvoicecallhandler.h>
+#include <voicecallchangeset.h>
+
+#include <QDBusArgument>
+#include <QDBusVirtualObject>
+
+class VoiceCallManagerInterface;
+
+class VoiceCallHandlerDBusDispatcher : public QDBusVirtualObject
+{
+    Q_OBJECT
+
+public:
+    explicit VoiceCallHandlerDBusDispatcher(VoiceCallManagerInterface *manager, QObject *parent = 0);
+    ~VoiceCallHandlerDBusDispatcher();
+
+    void setLegacySignals(bool on);
+
+    QString introspect(const QString &path) const;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection);
+
+    void publish(const VoiceCallChangeSet &changes);
+
+    QVariantMap properties(const AbstractVoiceCallHandler *handler) const;
+
+private:
+    class VoiceCallHandlerDBusDispatcherPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(VoiceCallHandlerDBusDispatcher)
+};
+
+QDBusArgument &operator<<(QDBusArgument &argument, AbstractVoiceCallHandler::VoiceCallFilterAction action);
+const QDBusArgument &operator>>(const QDBusArgument &argument, AbstractVoiceCallHandler::VoiceCallFilterAction &action);
+
+Q_DECLARE_METATYPE(AbstractVoiceCallHandler::VoiceCallFilterAction)
+
+#endif // VOICECALLHANDLERDBUSDISPATCHER_H
@@ -22,6 +22,11 @@
 #include "voicecallmanagerdbusadapter.h"
 
 #include "voicecallmanagerinterface.h"
+#include "voicecallapplication.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QTimer>
 
 /*!
   \class VoiceCallManagerDBusAdapter
@@ -33,13 +38,100 @@ class VoiceCallManagerDBusAdapterPrivate
 
 public:
     VoiceCallManagerDBusAdapterPrivate(VoiceCallManagerDBusAdapter *q)
-        : q_ptr(q), manager(NULL)
+        : q_ptr(q), manager(NULL), legacySignals(false)
     {/*...*/}
 
+    enum Property {
+        PROPERTY_PROVIDERS = 0x001,
+        PROPERTY_VOICE_CALLS = 0x002,
+        PROPERTY_ACTIVE_VOICE_CALL = 0x004,
+        PROPERTY_AUDIO_MODE = 0x008,
+        PROPERTY_AUDIO_ROUTED = 0x010,
+        PROPERTY_MICROPHONE_MUTED = 0x020,
+        PROPERTY_SPEAKER_MUTED = 0x040,
+        PROPERTY_TOTAL_OUTGOING_CALL_DURATION = 0x080,
+        PROPERTY_TOTAL_INCOMING_CALL_DURATION = 0x100
+    };
+    Q_DECLARE_FLAGS(Properties, Property)
+
+    void propertyChanged(Property property)
+    {
+        changed |= property;
+        if (!propertiesTimer.isActive())
+            propertiesTimer.start();
+    }
+
+    void emitPropertiesChanged();
+
     VoiceCallManagerDBusAdapter *q_ptr;
     VoiceCallManagerInterface *manager;
+
+    // Changes made in one event loop turn go out as one signal.
+    Properties changed;
+    QTimer propertiesTimer;
+    bool legacySignals;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(VoiceCallManagerDBusAdapterPrivate::Properties)
+
+void VoiceCallManagerDBusAdapterPrivate::emitPropertiesChanged()
+{
+    Q_Q(VoiceCallManagerDBusAdapter);
+    const Properties properties = changed;
+    changed = Properties();
+
+    QVariantMap values;
+    if (properties & PROPERTY_PROVIDERS)
+        values.insert("providers", q->providers());
+    if (properties & PROPERTY_VOICE_CALLS)
+        values.insert("voiceCalls", q->voiceCalls());
+    if (properties & PROPERTY_ACTIVE_VOICE_CALL)
+        values.insert("activeVoiceCall", q->activeVoiceCall());
+    if (properties & PROPERTY_AUDIO_MODE)
+        values.insert("audioMode", q->audioMode());
+    if (properties & PROPERTY_AUDIO_ROUTED)
+        values.insert("isAudioRouted", q->isAudioRouted());
+    if (properties & PROPERTY_MICROPHONE_MUTED)
+        values.insert("isMicrophoneMuted", q->isMicrophoneMuted());
+    if (properties & PROPERTY_SPEAKER_MUTED)
+        values.insert("isSpeakerMuted", q->isSpeakerMuted());
+    if (properties & PROPERTY_TOTAL_OUTGOING_CALL_DURATION)
+        values.insert("totalOutgoingCallDuration", q->totalOutgoingCallDuration());
+    if (properties & PROPERTY_TOTAL_INCOMING_CALL_DURATION)
+        values.insert("totalIncomingCallDuration", q->totalIncomingCallDuration());
+    if (values.isEmpty())
+        return;
+
+    QDBusConnection::sessionBus().send(
+                QDBusMessage::createSignal(QStringLiteral("/"),
+                                           QStringLiteral("org.freedesktop.DBus.Properties"),
+                                           QStringLiteral("PropertiesChanged"))
+                << QStringLiteral("org.nemomobile.voicecall.VoiceCallManager")
+                << values
+                << QStringList());
+
+    if (!legacySignals)
+        return;
+    if (properties & PROPERTY_PROVIDERS)
+        emit q->providersChanged();
+    if (properties & PROPERTY_VOICE_CALLS)
+        emit q->voiceCallsChanged();
+    if (properties & PROPERTY_ACTIVE_VOICE_CALL)
+        emit q->activeVoiceCallChanged();
+    if (properties & PROPERTY_AUDIO_MODE)
+        emit q->audioModeChanged();
+    if (properties & PROPERTY_AUDIO_ROUTED)
+        emit q->audioRoutedChanged();
+    if (properties & PROPERTY_MICROPHONE_MUTED)
+        emit q->microphoneMutedChanged();
+    if (properties & PROPERTY_SPEAKER_MUTED)
+        emit q->speakerMutedChanged();
+    if (properties & PROPERTY_TOTAL_OUTGOING_CALL_DURATION)
+        emit q->totalOutgoingCallDurationChanged();
+    if (properties & PROPERTY_TOTAL_INCOMING_CALL_DURATION)
+        emit q->totalIncomingCallDurationChanged();
+}
+
 /*!
   Constructs a new DBus adapter.
 */
@@ -47,6 +139,10 @@ VoiceCallManagerDBusAdapter::VoiceCallManagerDBusAdapter(QObject *parent)
     : QDBusAbstractAdaptor(parent), d_ptr(new VoiceCallManagerDBusAdapterPrivate(this))
 {
     TRACE
+    Q_D(VoiceCallManagerDBusAdapter);
+    d->propertiesTimer.setSingleShot(true);
+    d->propertiesTimer.setInterval(0);
+    QObject::connect(&d->propertiesTimer, &QTimer::timeout, this, [d] () { d->emitPropertiesChanged(); });
 }
 
 VoiceCallManagerDBusAdapter::~VoiceCallManagerDBusAdapter()
@@ -65,15 +161,39 @@ void VoiceCallManagerDBusAdapter::configure(VoiceCallManagerInterface *manager)
     Q_D(VoiceCallManagerDBusAdapter);
     d->manager = manager;
     QObject::connect(d->manager, SIGNAL(error(QString)), SIGNAL(error(QString)));
-    QObject::connect(d->manager, SIGNAL(providersChanged()), SIGNAL(providersChanged()));
-    QObject::connect(d->manager, SIGNAL(voiceCallsChanged()), SIGNAL(voiceCallsChanged()));
-    QObject::connect(d->manager, SIGNAL(activeVoiceCallChanged()), SIGNAL(activeVoiceCallChanged()));
-    QObject::connect(d->manager, SIGNAL(audioModeChanged()), SIGNAL(audioModeChanged()));
-    QObject::connect(d->manager, SIGNAL(audioRoutedChanged()), SIGNAL(audioRoutedChanged()));
-    QObject::connect(d->manager, SIGNAL(microphoneMutedChanged()), SIGNAL(microphoneMutedChanged()));
-    QObject::connect(d->manager, SIGNAL(speakerMutedChanged()), SIGNAL(speakerMutedChanged()));
-    QObject::connect(d->manager, SIGNAL(totalOutgoingCallDurationChanged()), SIGNAL(totalOutgoingCallDurationChanged()));
-    QObject::connect(d->manager, SIGNAL(totalIncomingCallDurationChanged()), SIGNAL(totalIncomingCallDurationChanged()));
+    QObject::connect(d->manager, &VoiceCallManagerInterface::providersChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_PROVIDERS); });
+    // Follows the change sets, committed once per event loop turn.
+    QObject::connect(d->manager, &VoiceCallManagerInterface::changeSetCommitted,
+                     this, [d] (const VoiceCallChangeSet &changes) {
+                         if (changes.voiceCallsChanged())
+                             d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_VOICE_CALLS);
+                         if (changes.activeVoiceCallChanged)
+                             d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_ACTIVE_VOICE_CALL);
+                     });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::audioModeChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_AUDIO_MODE); });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::audioRoutedChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_AUDIO_ROUTED); });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::microphoneMutedChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_MICROPHONE_MUTED); });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::speakerMutedChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_SPEAKER_MUTED); });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::totalOutgoingCallDurationChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_TOTAL_OUTGOING_CALL_DURATION); });
+    QObject::connect(d->manager, &VoiceCallManagerInterface::totalIncomingCallDurationChanged,
+                     this, [d] () { d->propertyChanged(VoiceCallManagerDBusAdapterPrivate::PROPERTY_TOTAL_INCOMING_CALL_DURATION); });
+}
+
+/*!
+  Whether the per property change signals are sent along with
+  PropertiesChanged, see VoiceCallManager::legacySignals().
+*/
+void VoiceCallManagerDBusAdapter::setLegacySignals(bool on)
+{
+    TRACE
+    Q_D(VoiceCallManagerDBusAdapter);
+    d->legacySignals = on;
 }
 
 /*!
@@ -198,6 +318,97 @@ void VoiceCallManagerDBusAdapter::resetCallDurationCounters()
     return d->manager->resetCallDurationCounters();
 }
 
+/*!
+  Returns the call lifecycle latency histograms, keyed by stage.
+
+  \sa getLifecycleTimelines(), resetLifecycleStatistics()
+*/
+QVariantMap VoiceCallManagerDBusAdapter::getLifecycleStatistics() const
+{
+    TRACE
+    Q_D(const VoiceCallManagerDBusAdapter);
+    return d->manager->lifecycleStatistics();
+}
+
+/*!
+  Returns the event timelines of the ongoing and last ended calls.
+
+  \sa getLifecycleStatistics()
+*/
+QVariantList VoiceCallManagerDBusAdapter::getLifecycleTimelines() const
+{
+    TRACE
+    Q_D(const VoiceCallManagerDBusAdapter);
+    return d->manager->lifecycleTimelines();
+}
+
+/*!
+  Clears the call lifecycle latency histograms and ended timelines.
+
+  \sa getLifecycleStatistics()
+*/
+void VoiceCallManagerDBusAdapter::resetLifecycleStatistics()
+{
+    TRACE
+    Q_D(VoiceCallManagerDBusAdapter);
+    d->manager->resetLifecycleStatistics();
+}
+
+/*!
+  Returns the trace points recorded by the threads of the service, in
+  the binary format described in voicecalltrace.h, which the
+  voicecall-trace tool prints as text.
+*/
+QByteArray VoiceCallManagerDBusAdapter::dumpTrace() const
+{
+    return VoiceCallTrace::dump();
+}
+
+/*!
+  Returns the last and the largest event loop lag in milliseconds of
+  the main thread and of the plugins running in their own thread.
+
+  The event loops are only probed while there are calls, and for a
+  minute after this is called: the lags are up to date when called
+  again meanwhile.
+
+  \sa getSlowDispatches()
+*/
+QVariantMap VoiceCallManagerDBusAdapter::getEventLoopLatencies() const
+{
+    TRACE
+    VoiceCallApplication *app = VoiceCallApplication::instance();
+    if (!app)
+        return QVariantMap();
+    app->requestStallReport();
+    return app->eventLoopLatencies();
+}
+
+/*!
+  Returns the receivers, slots and plugin calls that held an event
+  loop the longest during the last hour, slowest first.
+
+  \sa getEventLoopLatencies(), resetSlowDispatches()
+*/
+QVariantList VoiceCallManagerDBusAdapter::getSlowDispatches() const
+{
+    TRACE
+    VoiceCallApplication *app = VoiceCallApplication::instance();
+    return app ? app->slowDispatches() : QVariantList();
+}
+
+/*!
+  Forgets the slow dispatches recorded so far.
+
+  \sa getSlowDispatches()
+*/
+void VoiceCallManagerDBusAdapter::resetSlowDispatches()
+{
+    TRACE
+    if (VoiceCallApplication *app = VoiceCallApplication::instance())
+        app->resetSlowDispatches();
+}
+
 /*!
   Returns the status of the microphone mute flag.
 
@@ -51,6 +51,7 @@ public:
     ~VoiceCallManagerDBusAdapter();
 
     void configure(VoiceCallManagerInterface *manager);
+    void setLegacySignals(bool on);
 
     QStringList providers() const;
     QStringList voiceCalls() const;
@@ -99,6 +100,16 @@ public Q_SLOTS:
 
     void resetCallDurationCounters();
 
+    QVariantMap getLifecycleStatistics() const;
+    QVariantList getLifecycleTimelines() const;
+    void resetLifecycleStatistics();
+
+    QByteArray dumpTrace() const;
+
+    QVariantMap getEventLoopLatencies() const;
+    QVariantList getSlowDispatches() const;
+    void resetSlowDispatches();
+
 private:
     class VoiceCallManagerDBusAdapterPrivate *d_ptr;
 
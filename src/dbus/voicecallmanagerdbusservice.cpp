@@ -22,13 +22,17 @@
 
 #include "voicecallmanagerdbusservice.h"
 #include "voicecallmanagerdbusadapter.h"
-#include "voicecallhandlerdbusadapter.h"
+#include "voicecallhandlerdbusdispatcher.h"
+#include "voicecallobjectmanagerdbusadapter.h"
+#include "voicecallmanager.h"
 
 #include <voicecallmanagerinterface.h>
+#include <voicecallhandlerid.h>
 
 #include <QDBusError>
 #include <QDBusConnection>
 #include <QDBusMetaType>
+#include <QSet>
 
 class VoiceCallManagerDBusServicePrivate
 {
@@ -36,13 +40,18 @@ class VoiceCallManagerDBusServicePrivate
 
 public:
     VoiceCallManagerDBusServicePrivate(VoiceCallManagerDBusService *q)
-        : q_ptr(q), manager(NULL), managerAdapter(NULL)
+        : q_ptr(q), manager(NULL), managerAdapter(NULL), objectManagerAdapter(NULL), dispatcher(NULL)
     {/* ... */}
 
     VoiceCallManagerDBusService *q_ptr;
 
     VoiceCallManagerInterface *manager;
     VoiceCallManagerDBusAdapter *managerAdapter;
+    VoiceCallObjectManagerDBusAdapter *objectManagerAdapter;
+    VoiceCallHandlerDBusDispatcher *dispatcher;
+
+    // The calls published by the object manager.
+    QSet<VoiceCallHandlerId> registered;
 };
 
 VoiceCallManagerDBusService::VoiceCallManagerDBusService(QObject *parent)
@@ -76,22 +85,37 @@ bool VoiceCallManagerDBusService::configure(VoiceCallManagerInterface *manager)
     TRACE
     Q_D(VoiceCallManagerDBusService);
 
+    // The per property signals, superseded by PropertiesChanged, are
+    // only sent for clients asking for them.
+    const bool legacySignals = VoiceCallManager::legacySignals();
+
     d->manager = manager;
     d->managerAdapter = new VoiceCallManagerDBusAdapter(manager);
+    d->managerAdapter->setLegacySignals(legacySignals);
+
+    // One object serves every call, see VoiceCallHandlerDBusDispatcher.
+    d->dispatcher = new VoiceCallHandlerDBusDispatcher(manager, this);
+    d->dispatcher->setLegacySignals(legacySignals);
+    d->objectManagerAdapter = new VoiceCallObjectManagerDBusAdapter(d->dispatcher, manager);
 
     if (!QDBusConnection::sessionBus().registerObject("/", manager)) {
         WARNING_T("Failed to register DBus object: %s", qPrintable(QDBusConnection::sessionBus().lastError().message()));
         return false;
     }
 
+    if (!QDBusConnection::sessionBus().registerVirtualObject("/calls", d->dispatcher, QDBusConnection::SubPath)) {
+        WARNING_T("Failed to register DBus object: %s", qPrintable(QDBusConnection::sessionBus().lastError().message()));
+        return false;
+    }
+
     if (!QDBusConnection::sessionBus().registerService("org.nemomobile.voicecall")) {
         WARNING_T("Failed to register DBus service: %s", qPrintable(QDBusConnection::sessionBus().lastError().message()));
         return false;
     }
 
-    QObject::connect(manager, SIGNAL(voiceCallAdded(AbstractVoiceCallHandler*)), SLOT(onVoiceCallAdded(AbstractVoiceCallHandler*)));
-    QObject::connect(manager, SIGNAL(voiceCallRemoved(QString)), SLOT(onVoiceCallRemoved(QString)));
-    QObject::connect(manager, SIGNAL(activeVoiceCallChanged()), SLOT(onActiveVoiceCallChanged()));
+    // Connected ahead of the adapter, so objects are in place
+    // by the time it signals the changes.
+    QObject::connect(manager, SIGNAL(changeSetCommitted(VoiceCallChangeSet)), SLOT(onChangeSetCommitted(VoiceCallChangeSet)));
 
     d->managerAdapter->configure(manager);
     return true;
@@ -120,35 +144,42 @@ void VoiceCallManagerDBusService::finalize()
     TRACE
 }
 
-void VoiceCallManagerDBusService::onVoiceCallAdded(AbstractVoiceCallHandler *handler)
+void VoiceCallManagerDBusService::onChangeSetCommitted(const VoiceCallChangeSet &changes)
 {
     TRACE
     Q_D(VoiceCallManagerDBusService);
 
-    new VoiceCallHandlerDBusAdapter(handler);
+    // The last changes of removed calls go out before their removal.
+    d->dispatcher->publish(changes);
 
-    if (!QDBusConnection::sessionBus().registerObject("/calls/" + handler->handlerId(), handler)) {
-        WARNING_T("Failed to register DBus object: %s", qPrintable(QDBusConnection::sessionBus().lastError().message()));
+    foreach (const QString &handlerId, changes.removed)
+        onVoiceCallRemoved(changes.id(handlerId));
+
+    foreach (const QString &handlerId, changes.added) {
+        AbstractVoiceCallHandler *handler = d->manager->voiceCall(handlerId);
+        if (handler)
+            onVoiceCallAdded(handler, changes.id(handlerId));
     }
 }
 
-void VoiceCallManagerDBusService::onVoiceCallRemoved(const QString &handlerId)
+void VoiceCallManagerDBusService::onVoiceCallAdded(AbstractVoiceCallHandler *handler, const VoiceCallHandlerId &id)
 {
     TRACE
     Q_D(VoiceCallManagerDBusService);
 
-    QDBusConnection::sessionBus().unregisterObject("/calls/" + handlerId);
+    if (id.isNull()) {
+        WARNING_T("Not publishing call with malformed handler id %s", qPrintable(handler->handlerId()));
+        return;
+    }
+    d->registered.insert(id);
+    d->objectManagerAdapter->addObject(id.objectPath(), handler);
 }
 
-void VoiceCallManagerDBusService::onActiveVoiceCallChanged()
+void VoiceCallManagerDBusService::onVoiceCallRemoved(const VoiceCallHandlerId &id)
 {
     TRACE
     Q_D(VoiceCallManagerDBusService);
 
-    if (d->manager->activeVoiceCall()) {
-        DEBUG_T("VoiceCallManagerDBusService:: registering active voice call interface.");
-        QDBusConnection::sessionBus().registerObject("/calls/active", d->manager->activeVoiceCall());
-    } else {
-        QDBusConnection::sessionBus().unregisterObject("/calls/active");
-    }
+    if (d->registered.remove(id))
+        d->objectManagerAdapter->removeObject(id.objectPath());
 }
@@ -23,6 +23,8 @@
 
 #include <abstractvoicecallhandler.h>
 #include <abstractvoicecallmanagerplugin.h>
+#include <voicecallchangeset.h>
+#include <voicecallhandlerid.h>
 
 class VoiceCallManagerDBusService : public AbstractVoiceCallManagerPlugin
 {
@@ -43,10 +45,10 @@ public Q_SLOTS:
     void finalize();
 
 protected Q_SLOTS:
-    void onVoiceCallAdded(AbstractVoiceCallHandler *handler);
-    void onVoiceCallRemoved(const QString &handlerId);
+    void onChangeSetCommitted(const VoiceCallChangeSet &changes);
 
-    void onActiveVoiceCallChanged();
+    void onVoiceCallAdded(AbstractVoiceCallHandler *handler, const VoiceCallHandlerId &id);
+    void onVoiceCallRemoved(const VoiceCallHandlerId &id);
 
 private:
     class VoiceCallManagerDBusServicePrivate *d_ptr;
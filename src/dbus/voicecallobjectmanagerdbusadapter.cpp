@@ -0,0 +1,116 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+#include "common.h"
+#include "voicecallobjectmanagerdbusadapter.h"
+#include "voicecallhandlerdbusdispatcher.h"
+
+#include <QDBusMetaType>
+#include <QPointer>
+
+namespace {
+const char *const VoiceCallInterface = "org.nemomobile.voicecall.VoiceCall";
+}
+
+/*!
+  \class VoiceCallObjectManagerDBusAdapter
+  \brief The org.freedesktop.DBus.ObjectManager interface of the voice
+         call manager service.
+
+  Lets clients fetch every call along with its properties in a single
+  round trip, and follow calls coming and going through
+  InterfacesAdded and InterfacesRemoved. The /calls/active alias is not
+  listed, the activeVoiceCall property of the manager points to it.
+*/
+class VoiceCallObjectManagerDBusAdapterPrivate
+{
+    Q_DECLARE_PUBLIC(VoiceCallObjectManagerDBusAdapter)
+
+public:
+    VoiceCallObjectManagerDBusAdapterPrivate(VoiceCallObjectManagerDBusAdapter *q,
+                                             VoiceCallHandlerDBusDispatcher *pDispatcher)
+        : q_ptr(q), dispatcher(pDispatcher)
+    {/*...*/}
+
+    VoiceCallObjectManagerDBusAdapter *q_ptr;
+    VoiceCallHandlerDBusDispatcher *dispatcher;
+
+    QMap<QDBusObjectPath, QPointer<AbstractVoiceCallHandler> > objects;
+};
+
+VoiceCallObjectManagerDBusAdapter::VoiceCallObjectManagerDBusAdapter(VoiceCallHandlerDBusDispatcher *dispatcher,
+                                                                     QObject *parent)
+    : QDBusAbstractAdaptor(parent), d_ptr(new VoiceCallObjectManagerDBusAdapterPrivate(this, dispatcher))
+{
+    TRACE
+    qDBusRegisterMetaType<VoiceCallInterfaceList>();
+    qDBusRegisterMetaType<VoiceCallManagedObjectList>();
+}
+
+VoiceCallObjectManagerDBusAdapter::~VoiceCallObjectManagerDBusAdapter()
+{
+    TRACE
+    Q_D(VoiceCallObjectManagerDBusAdapter);
+    delete d;
+}
+
+/*!
+  Publishes \a handler, registered on the bus at \a path.
+*/
+void VoiceCallObjectManagerDBusAdapter::addObject(const QString &path, AbstractVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(VoiceCallObjectManagerDBusAdapter);
+    const QDBusObjectPath objectPath(path);
+    d->objects.insert(objectPath, handler);
+
+    VoiceCallInterfaceList interfaces;
+    interfaces.insert(VoiceCallInterface, d->dispatcher->properties(handler));
+    emit InterfacesAdded(objectPath, interfaces);
+}
+
+void VoiceCallObjectManagerDBusAdapter::removeObject(const QString &path)
+{
+    TRACE
+    Q_D(VoiceCallObjectManagerDBusAdapter);
+    const QDBusObjectPath objectPath(path);
+    if (d->objects.remove(objectPath))
+        emit InterfacesRemoved(objectPath, QStringList() << VoiceCallInterface);
+}
+
+/*!
+  Returns every call on the bus with its properties.
+*/
+VoiceCallManagedObjectList VoiceCallObjectManagerDBusAdapter::GetManagedObjects() const
+{
+    TRACE
+    Q_D(const VoiceCallObjectManagerDBusAdapter);
+    VoiceCallManagedObjectList result;
+
+    for (QMap<QDBusObjectPath, QPointer<AbstractVoiceCallHandler> >::const_iterator it = d->objects.constBegin();
+         it != d->objects.constEnd(); ++it) {
+        if (!it.value())
+            continue;
+        VoiceCallInterfaceList interfaces;
+        interfaces.insert(VoiceCallInterface, d->dispatcher->properties(it.value()));
+        result.insert(it.key(), interfaces);
+    }
+    return result;
+}
@@ -0,0 +1,65 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+#ifndef VOICECALLOBJECTMANAGERDBUSADAPTER_H
+#define VOICECALLOBJECTMANAGERDBUSADAPTER_H
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusObjectPath>
+#include <QMap>
+#include <QVariantMap>
+
+class AbstractVoiceCallHandler;
+class VoiceCallHandlerDBusDispatcher;
+
+// a{sa{sv}}: the properties of an object, by interface.
+typedef QMap<QString, QVariantMap> VoiceCallInterfaceList;
+// a{oa{sa{sv}}}
+typedef QMap<QDBusObjectPath, VoiceCallInterfaceList> VoiceCallManagedObjectList;
+
+class VoiceCallObjectManagerDBusAdapter : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.DBus.ObjectManager")
+
+public:
+    explicit VoiceCallObjectManagerDBusAdapter(VoiceCallHandlerDBusDispatcher *dispatcher, QObject *parent = 0);
+    ~VoiceCallObjectManagerDBusAdapter();
+
+    void addObject(const QString &path, AbstractVoiceCallHandler *handler);
+    void removeObject(const QString &path);
+
+Q_SIGNALS:
+    void InterfacesAdded(const QDBusObjectPath &path, const VoiceCallInterfaceList &interfaces);
+    void InterfacesRemoved(const QDBusObjectPath &path, const QStringList &interfaces);
+
+public Q_SLOTS:
+    VoiceCallManagedObjectList GetManagedObjects() const;
+
+private:
+    class VoiceCallObjectManagerDBusAdapterPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(VoiceCallObjectManagerDBusAdapter)
+};
+
+Q_DECLARE_METATYPE(VoiceCallInterfaceList)
+Q_DECLARE_METATYPE(VoiceCallManagedObjectList)
+
+#endif // VOICECALLOBJECTMANAGERDBUSADAPTER_H
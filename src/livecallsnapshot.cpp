@@ -0,0 +1,382 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "common.h"
+#include "livecallsnapshot.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+const char Magic[4] = { 'V', 'C', 'L', 'S' };
+const quint32 Version = 2;
+const int SlotCount = 16;
+// Calls of the previous run not claimed back by then are gone.
+const int ClaimDelay = 30000;
+
+struct Header {
+    char magic[4];
+    quint32 version;
+    quint32 slotCount;
+    quint32 entrySize;
+};
+
+struct Entry {
+    qint64 startedAt;   // ms since the epoch, 0 when unknown
+    qint64 updatedAt;   // ms since the epoch
+    qint32 duration;    // s, as of updatedAt
+    qint8 status;
+    qint8 verdict;      // -1 until filtered
+    quint8 incoming;
+    quint8 used;        // set last on creation, cleared first on removal
+    char handlerId[40];
+    char providerId[88];
+    char path[120];
+    char lineId[64];
+};
+
+bool store(char *field, size_t size, const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    if (size_t(utf8.size()) >= size)
+        return false;
+    memcpy(field, utf8.constData(), utf8.size());
+    memset(field + utf8.size(), 0, size - utf8.size());
+    return true;
+}
+
+template <size_t N>
+QString load(const char (&field)[N])
+{
+    return QString::fromUtf8(field, qstrnlen(field, N));
+}
+
+QString key(const QString &providerId, const QString &path)
+{
+    return providerId + QLatin1Char('\n') + path;
+}
+
+}
+
+/*!
+  \class LiveCallSnapshot
+  \brief The calls in progress, kept in a memory mapped file.
+
+  Each call a provider reclaims by its path gets a fixed-size slot,
+  updated in place as the call changes. Since the mapping is shared,
+  the slots outlive a crash of the manager: once restarted, providers
+  reclaiming the same paths get their former handler ids back, with
+  the start time, duration, direction and filter verdict of the calls.
+  Providers reuse the paths of ended calls, oFono among them, so a
+  call is only taken for the one of a slot if its line and its start
+  time, when both are known, are the same.
+
+  The file lives in the runtime directory, so it does not survive a
+  reboot, and slots left unclaimed a while after startup are dropped.
+*/
+class LiveCallSnapshotPrivate
+{
+    Q_DECLARE_PUBLIC(LiveCallSnapshot)
+
+public:
+    LiveCallSnapshotPrivate(LiveCallSnapshot *q, const QString &fileName)
+        : q_ptr(q), file(fileName), map(NULL)
+    {/* ... */}
+
+    bool open();
+
+    Entry *entry(int slot) const
+    {
+        return reinterpret_cast<Entry *>(map + sizeof(Header)) + slot;
+    }
+
+    int freeSlot();
+    void clear(int slot);
+    bool matches(const Entry *e, const QString &lineId, const QDateTime &startedAt) const;
+
+    LiveCallSnapshot *q_ptr;
+
+    QFile file;
+    uchar *map;
+
+    // Handler ids of this run, and provider paths of the previous one.
+    QHash<QString, int> slots;
+    QHash<QString, int> previous;
+};
+
+bool LiveCallSnapshotPrivate::open()
+{
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    if (!file.open(QIODevice::ReadWrite)) {
+        WARNING_T("Cannot open call snapshot %s: %s", qPrintable(file.fileName()),
+                  qPrintable(file.errorString()));
+        return false;
+    }
+
+    const qint64 size = sizeof(Header) + SlotCount * sizeof(Entry);
+    const bool resized = file.size() != size;
+    if (resized && !file.resize(size)) {
+        WARNING_T("Cannot resize call snapshot %s", qPrintable(file.fileName()));
+        return false;
+    }
+    map = file.map(0, size);
+    if (!map) {
+        WARNING_T("Cannot map call snapshot %s", qPrintable(file.fileName()));
+        return false;
+    }
+
+    Header *header = reinterpret_cast<Header *>(map);
+    if (resized || memcmp(header->magic, Magic, sizeof(Magic))
+            || header->version != Version
+            || header->slotCount != SlotCount
+            || header->entrySize != sizeof(Entry)) {
+        memset(map, 0, size);
+        memcpy(header->magic, Magic, sizeof(Magic));
+        header->version = Version;
+        header->slotCount = SlotCount;
+        header->entrySize = sizeof(Entry);
+        return true;
+    }
+
+    for (int slot = 0; slot < SlotCount; slot++) {
+        const Entry *e = entry(slot);
+        if (e->used)
+            previous.insert(key(load(e->providerId), load(e->path)), slot);
+    }
+    if (!previous.isEmpty())
+        DEBUG_T("%d calls to reclaim", previous.count());
+    return true;
+}
+
+int LiveCallSnapshotPrivate::freeSlot()
+{
+    int oldest = 0;
+    for (int slot = 0; slot < SlotCount; slot++) {
+        if (!entry(slot)->used)
+            return slot;
+        if (entry(slot)->updatedAt < entry(oldest)->updatedAt)
+            oldest = slot;
+    }
+
+    // Full of calls their provider never validated, reuse the stalest.
+    WARNING_T("Call snapshot full, dropping %s", entry(oldest)->handlerId);
+    clear(oldest);
+    return oldest;
+}
+
+void LiveCallSnapshotPrivate::clear(int slot)
+{
+    for (QHash<QString, int>::iterator it = slots.begin(); it != slots.end();) {
+        it = it.value() == slot ? slots.erase(it) : it + 1;
+    }
+    for (QHash<QString, int>::iterator it = previous.begin(); it != previous.end();) {
+        it = it.value() == slot ? previous.erase(it) : it + 1;
+    }
+
+    Entry *e = entry(slot);
+    e->used = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(e, 0, sizeof(Entry));
+}
+
+// Start times are compared to the second, not all providers know better.
+bool LiveCallSnapshotPrivate::matches(const Entry *e, const QString &lineId, const QDateTime &startedAt) const
+{
+    if (load(e->lineId) != lineId)
+        return false;
+    return !e->startedAt || !startedAt.isValid()
+            || e->startedAt / 1000 == startedAt.toMSecsSinceEpoch() / 1000;
+}
+
+LiveCallSnapshot::LiveCallSnapshot(QObject *parent)
+    : LiveCallSnapshot(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)
+                       + QStringLiteral("/voicecall/calls.snapshot"), parent)
+{
+}
+
+LiveCallSnapshot::LiveCallSnapshot(const QString &fileName, QObject *parent)
+    : QObject(parent), d_ptr(new LiveCallSnapshotPrivate(this, fileName))
+{
+    TRACE
+    Q_D(LiveCallSnapshot);
+    if (d->open() && !d->previous.isEmpty())
+        QTimer::singleShot(ClaimDelay, this, SLOT(dropUnclaimed()));
+}
+
+LiveCallSnapshot::~LiveCallSnapshot()
+{
+    TRACE
+    delete d_ptr;
+}
+
+QString LiveCallSnapshot::fileName() const
+{
+    Q_D(const LiveCallSnapshot);
+    return d->file.fileName();
+}
+
+/*!
+  Returns the call that was known at \a path of \a providerId before
+  the manager restarted, if it went to \a lineId and started at
+  \a startedAt as well. Otherwise, the call is recorded from now on
+  under \a handlerId.
+*/
+VoiceCallManagerInterface::ReclaimedVoiceCall LiveCallSnapshot::reclaim(const QString &providerId,
+                                                                        const QString &path,
+                                                                        const QString &lineId,
+                                                                        const QDateTime &startedAt,
+                                                                        const QString &handlerId)
+{
+    TRACE
+    Q_D(LiveCallSnapshot);
+    VoiceCallManagerInterface::ReclaimedVoiceCall result;
+    result.handlerId = handlerId;
+    if (!d->map)
+        return result;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QHash<QString, int>::iterator it = d->previous.find(key(providerId, path));
+    if (it != d->previous.end() && !d->matches(d->entry(it.value()), lineId, startedAt)) {
+        DEBUG_T("Call at %s is not %s any more", qPrintable(path), d->entry(it.value())->handlerId);
+        d->clear(it.value());
+        it = d->previous.end();
+    }
+    if (it != d->previous.end()) {
+        const int slot = it.value();
+        d->previous.erase(it);
+
+        const Entry *e = d->entry(slot);
+        result.handlerId = load(e->handlerId);
+        if (e->startedAt)
+            result.startedAt = QDateTime::fromMSecsSinceEpoch(e->startedAt);
+        result.duration = e->duration;
+        // The call kept going while nobody was counting.
+        if (e->status == AbstractVoiceCallHandler::STATUS_ACTIVE
+                || e->status == AbstractVoiceCallHandler::STATUS_HELD)
+            result.duration += int((now - e->updatedAt) / 1000);
+        result.isIncoming = e->incoming;
+        result.isReclaimed = true;
+        d->slots.insert(result.handlerId, slot);
+        return result;
+    }
+
+    const int slot = d->freeSlot();
+    Entry *e = d->entry(slot);
+    if (!store(e->handlerId, sizeof(e->handlerId), handlerId)
+            || !store(e->providerId, sizeof(e->providerId), providerId)
+            || !store(e->path, sizeof(e->path), path)
+            || !store(e->lineId, sizeof(e->lineId), lineId)) {
+        WARNING_T("Call %s at %s does not fit in a slot, it will not be reclaimed after a restart",
+                  qPrintable(handlerId), qPrintable(path));
+        memset(e, 0, sizeof(Entry));
+        return result;
+    }
+    e->startedAt = startedAt.isValid() ? startedAt.toMSecsSinceEpoch() : 0;
+    e->updatedAt = now;
+    e->duration = 0;
+    e->status = AbstractVoiceCallHandler::STATUS_NULL;
+    e->verdict = -1;
+    e->incoming = false;
+    std::atomic_thread_fence(std::memory_order_release);
+    e->used = 1;
+    d->slots.insert(handlerId, slot);
+    return result;
+}
+
+/*!
+  Retrieves the filter verdict already given to \a handlerId into
+  \a action, returns false when the call was not filtered yet.
+*/
+bool LiveCallSnapshot::verdict(const QString &handlerId,
+                               AbstractVoiceCallHandler::VoiceCallFilterAction *action) const
+{
+    TRACE
+    Q_D(const LiveCallSnapshot);
+    QHash<QString, int>::const_iterator it = d->slots.constFind(handlerId);
+    if (it == d->slots.constEnd() || d->entry(it.value())->verdict < 0)
+        return false;
+
+    *action = AbstractVoiceCallHandler::VoiceCallFilterAction(d->entry(it.value())->verdict);
+    return true;
+}
+
+void LiveCallSnapshot::update(const AbstractVoiceCallHandler *handler)
+{
+    TRACE
+    Q_D(LiveCallSnapshot);
+    QHash<QString, int>::const_iterator it = d->slots.constFind(handler->handlerId());
+    if (it == d->slots.constEnd())
+        return;
+
+    Entry *e = d->entry(it.value());
+    const AbstractVoiceCallHandler::VoiceCallStatus status = handler->status();
+    const QDateTime startedAt = handler->startedAt();
+    if (startedAt.isValid())
+        e->startedAt = startedAt.toMSecsSinceEpoch();
+    // Lines may be known late, those not fitting are left as they were.
+    store(e->lineId, sizeof(e->lineId), handler->lineId());
+    e->updatedAt = QDateTime::currentMSecsSinceEpoch();
+    e->duration = handler->duration();
+    e->status = status;
+    e->incoming = handler->isIncoming();
+
+    // Leaving the NULL state is the outcome of filtering.
+    if (e->verdict < 0 && e->incoming && status != AbstractVoiceCallHandler::STATUS_NULL) {
+        switch (status) {
+        case AbstractVoiceCallHandler::STATUS_REJECTED:
+            e->verdict = AbstractVoiceCallHandler::ACTION_REJECT;
+            break;
+        case AbstractVoiceCallHandler::STATUS_IGNORED:
+            e->verdict = AbstractVoiceCallHandler::ACTION_IGNORE;
+            break;
+        default:
+            e->verdict = AbstractVoiceCallHandler::ACTION_CONTINUE;
+            break;
+        }
+    }
+}
+
+void LiveCallSnapshot::remove(const QString &handlerId)
+{
+    TRACE
+    Q_D(LiveCallSnapshot);
+    QHash<QString, int>::const_iterator it = d->slots.constFind(handlerId);
+    if (it != d->slots.constEnd())
+        d->clear(it.value());
+}
+
+void LiveCallSnapshot::dropUnclaimed()
+{
+    TRACE
+    Q_D(LiveCallSnapshot);
+    foreach (int slot, d->previous.values()) {
+        DEBUG_T("Dropping unclaimed call %s", d->entry(slot)->handlerId);
+        d->clear(slot);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LIVECALLSNAPSHOT_H
+#define LIVECALLSNAPSHOT_H
+
+#include <voicecallmanagerinterface.h>
+
+class LiveCallSnapshot : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveCallSnapshot(QObject *parent = 0);
+    explicit LiveCallSnapshot(const QString &fileName, QObject *parent = 0);
+    ~LiveCallSnapshot();
+
+    QString fileName() const;
+
+    VoiceCallManagerInterface::ReclaimedVoiceCall reclaim(const QString &providerId,
+                                                          const QString &path,
+                                                          const QString &lineId,
+                                                          const QDateTime &startedAt,
+                                                          const QString &handlerId);
+    bool verdict(const QString &handlerId,
+                 AbstractVoiceCallHandler::VoiceCallFilterAction *action) const;
+
+    void update(const AbstractVoiceCallHandler *handler);
+    void remove(const QString &handlerId);
+
+protected Q_SLOTS:
+    void dropUnclaimed();
+
+private:
+    class LiveCallSnapshotPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(LiveCallSnapshot)
+};
+
+#endif // LIVECALLSNAPSHOT_H
@@ -18,18 +18,28 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
  */
-#include <QCoreApplication>
+#include <QFile>
+#include <QStandardPaths>
 
+#include "common.h"
+
+#include "voicecallapplication.h"
 #include "voicecallmanager.h"
 #include "basicvoicecallconfigurator.h"
 
 Q_DECL_EXPORT int main(int argc, char **argv)
 {
-    QCoreApplication app(argc, argv);
+    VoiceCallApplication app(argc, argv);
 
     QCoreApplication::setOrganizationName("nemomobile");
     QCoreApplication::setApplicationName("voicecall");
 
+#if VOICECALL_TRACE_LEVEL > 0 && VOICECALL_TRACE_RECORDS
+    VoiceCallTrace::installCrashHandler(QFile::encodeName(
+            QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)
+            + QStringLiteral("/voicecall-manager.trace")));
+#endif
+
     VoiceCallManager manager;
     BasicVoiceCallConfigurator configurator;
 
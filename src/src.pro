@@ -25,15 +25,25 @@ HEADERS += \
     dbus/voicecallmanagerdbusservice.h \
     basicvoicecallconfigurator.h \
     voicecallmanager.h \
+    calldurationcounters.h \
+    livecallsnapshot.h \
+    voicecalllifecycletracer.h \
+    voicecallapplication.h \
     dbus/voicecallmanagerdbusadapter.h \
-    dbus/voicecallhandlerdbusadapter.h
+    dbus/voicecallhandlerdbusdispatcher.h \
+    dbus/voicecallobjectmanagerdbusadapter.h
 
 SOURCES += \
     dbus/voicecallmanagerdbusservice.cpp \
     dbus/voicecallmanagerdbusadapter.cpp \
-    dbus/voicecallhandlerdbusadapter.cpp \
+    dbus/voicecallhandlerdbusdispatcher.cpp \
+    dbus/voicecallobjectmanagerdbusadapter.cpp \
     basicvoicecallconfigurator.cpp \
     voicecallmanager.cpp \
+    calldurationcounters.cpp \
+    livecallsnapshot.cpp \
+    voicecalllifecycletracer.cpp \
+    voicecallapplication.cpp \
     main.cpp \
 
 enable-audiopolicy {
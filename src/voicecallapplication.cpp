@@ -0,0 +1,358 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "common.h"
+#include "voicecallapplication.h"
+
+#include <QDateTime>
+#include <QMutex>
+
+#include <algorithm>
+
+namespace {
+const int ProbeInterval = 1000;
+// How long probes keep running after a report was requested, in ms.
+const int ReportWindow = 60000;
+// ms of lag, and µs a dispatch may take before being reported.
+const int StallThreshold = 100;
+const qint64 SlowDispatch = 20000;
+const int MaxOffenders = 20;
+// Offenders not seen for that long are forgotten, in ms.
+const qint64 OffenderWindow = 60 * 60 * 1000;
+
+VoiceCallApplication *s_instance = NULL;
+
+struct Offender {
+    QString name;
+    int count;
+    qint64 maxUsecs;
+    qint64 totalUsecs;
+    qint64 lastSeen;
+};
+
+QString eventName(QEvent::Type type)
+{
+    switch (type) {
+    case QEvent::Timer:
+        return QStringLiteral("timer");
+    case QEvent::MetaCall:
+        return QStringLiteral("call");
+    case QEvent::SockAct:
+        return QStringLiteral("socket");
+    default:
+        return QStringLiteral("event %1").arg(int(type));
+    }
+}
+}
+
+EventLoopProbe::EventLoopProbe(const QString &name)
+    : m_timer(this)
+{
+    setObjectName(name);
+    m_timer.setInterval(ProbeInterval);
+    QObject::connect(&m_timer, &QTimer::timeout, this, &EventLoopProbe::probe);
+}
+
+void EventLoopProbe::setRunning(bool running)
+{
+    QMetaObject::invokeMethod(this, [this, running] () {
+        if (!running) {
+            m_timer.stop();
+        } else if (!m_timer.isActive()) {
+            m_clock.start();
+            m_timer.start();
+        }
+    }, Qt::QueuedConnection);
+}
+
+QVariantMap EventLoopProbe::latency() const
+{
+    QVariantMap result;
+    result.insert(QStringLiteral("lag"), m_lag.load());
+    result.insert(QStringLiteral("maxLag"), m_maxLag.load());
+    return result;
+}
+
+void EventLoopProbe::probe()
+{
+    const int lag = qMax<qint64>(0, m_clock.restart() - ProbeInterval);
+    m_lag.store(lag);
+    if (lag > m_maxLag.load())
+        m_maxLag.store(lag);
+    if (lag >= StallThreshold)
+        WARNING_T("Event loop of %s lagging by %d ms", qPrintable(objectName()), lag);
+}
+
+VoiceCallApplication::Scope::~Scope()
+{
+    const qint64 usecs = m_clock.nsecsElapsed() / 1000;
+    if (Q_UNLIKELY(usecs >= SlowDispatch) && s_instance) {
+        QString name = m_who;
+        if (!name.isEmpty())
+            name += QLatin1Char(' ');
+        name += QLatin1String(m_what);
+        s_instance->record(name, usecs);
+    }
+}
+
+/*!
+  \class VoiceCallApplication
+  \brief The application of the service, watching its event loops.
+
+  Every event dispatched in any thread is timed. The ones taking long
+  are reported with the class of their receiver, and of its parent, as
+  the slowest offenders of the last hour. Work that is not an event of
+  its own, like calling into plugins, is timed through Scope.
+
+  Only timing is done for events dispatched in time, nothing is
+  allocated nor locked.
+
+  The event loops are probed only while there are calls, or for a
+  while after a stall report was requested, not to wake up the device
+  when idle.
+*/
+class VoiceCallApplicationPrivate
+{
+    Q_DECLARE_PUBLIC(VoiceCallApplication)
+
+public:
+    VoiceCallApplicationPrivate(VoiceCallApplication *q)
+        : q_ptr(q), mainProbe(QStringLiteral("main")), busy(false), probing(false)
+    {/* ... */}
+
+    void expire(qint64 now)
+    {
+        for (QList<Offender>::iterator it = offenders.begin(); it != offenders.end();) {
+            it = now - it->lastSeen > OffenderWindow ? offenders.erase(it) : it + 1;
+        }
+    }
+
+    // Called from the main thread only.
+    void updateProbes()
+    {
+        const bool on = busy || reportTimer.isActive();
+        QMutexLocker locker(&lock);
+        if (on == probing)
+            return;
+        probing = on;
+        foreach (EventLoopProbe *probe, probes)
+            probe->setRunning(on);
+    }
+
+    VoiceCallApplication *q_ptr;
+
+    EventLoopProbe mainProbe;
+    QTimer reportTimer;
+    bool busy;
+    bool probing;
+
+    mutable QMutex lock;
+    QList<EventLoopProbe*> probes;
+    QList<Offender> offenders;
+};
+
+VoiceCallApplication::VoiceCallApplication(int &argc, char **argv)
+    : QCoreApplication(argc, argv), d_ptr(new VoiceCallApplicationPrivate(this))
+{
+    TRACE
+    Q_D(VoiceCallApplication);
+    s_instance = this;
+    d->probes.append(&d->mainProbe);
+    d->reportTimer.setSingleShot(true);
+    d->reportTimer.setInterval(ReportWindow);
+    QObject::connect(&d->reportTimer, &QTimer::timeout, this, [d] () { d->updateProbes(); });
+}
+
+VoiceCallApplication::~VoiceCallApplication()
+{
+    TRACE
+    s_instance = NULL;
+    delete d_ptr;
+}
+
+VoiceCallApplication *VoiceCallApplication::instance()
+{
+    return s_instance;
+}
+
+bool VoiceCallApplication::notify(QObject *receiver, QEvent *event)
+{
+    // Taken beforehand, the receiver may be gone once the event is handled.
+    const QEvent::Type type = event->type();
+    const QMetaObject *meta = receiver->metaObject();
+    const QMetaObject *owner = receiver->parent() ? receiver->parent()->metaObject() : NULL;
+
+    QElapsedTimer clock;
+    clock.start();
+    const bool result = QCoreApplication::notify(receiver, event);
+    const qint64 usecs = clock.nsecsElapsed() / 1000;
+
+    if (Q_UNLIKELY(usecs >= SlowDispatch)) {
+        QString name = QString::fromLatin1(meta->className());
+        if (owner) {
+            name += QLatin1Char('<');
+            name += QLatin1String(owner->className());
+            name += QLatin1Char('>');
+        }
+        name += QLatin1Char(' ');
+        name += eventName(type);
+        record(name, usecs);
+    }
+    return result;
+}
+
+void VoiceCallApplication::addProbe(EventLoopProbe *probe)
+{
+    TRACE
+    Q_D(VoiceCallApplication);
+    QMutexLocker locker(&d->lock);
+    d->probes.append(probe);
+    if (d->probing)
+        probe->setRunning(true);
+}
+
+void VoiceCallApplication::removeProbe(EventLoopProbe *probe)
+{
+    TRACE
+    Q_D(VoiceCallApplication);
+    QMutexLocker locker(&d->lock);
+    d->probes.removeOne(probe);
+}
+
+/*!
+  Tells whether there are calls, the event loops are probed while
+  there are.
+*/
+void VoiceCallApplication::setBusy(bool busy)
+{
+    Q_D(VoiceCallApplication);
+    if (d->busy == busy)
+        return;
+    d->busy = busy;
+    d->updateProbes();
+}
+
+/*!
+  Keeps the event loops probed for a minute, the latencies of idle
+  loops are known once the probes have fired.
+*/
+void VoiceCallApplication::requestStallReport()
+{
+    TRACE
+    Q_D(VoiceCallApplication);
+    d->reportTimer.start();
+    d->updateProbes();
+}
+
+/*!
+  Counts \a name as having taken \a usecs, from any thread. It is kept
+  if among the slowest offenders seen.
+*/
+void VoiceCallApplication::record(const QString &name, qint64 usecs)
+{
+    Q_D(VoiceCallApplication);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&d->lock);
+    d->expire(now);
+
+    QList<Offender>::iterator slowest = d->offenders.end();
+    QList<Offender>::iterator fastest = d->offenders.end();
+    for (QList<Offender>::iterator it = d->offenders.begin(); it != d->offenders.end(); ++it) {
+        if (it->name == name) {
+            slowest = it;
+            break;
+        }
+        if (fastest == d->offenders.end() || it->maxUsecs < fastest->maxUsecs)
+            fastest = it;
+    }
+
+    if (slowest == d->offenders.end()) {
+        Offender offender = { name, 0, 0, 0, now };
+        if (d->offenders.count() < MaxOffenders) {
+            d->offenders.append(offender);
+            slowest = d->offenders.end() - 1;
+        } else if (fastest->maxUsecs < usecs) {
+            *fastest = offender;
+            slowest = fastest;
+        } else {
+            return;
+        }
+    }
+    slowest->count++;
+    slowest->maxUsecs = qMax(slowest->maxUsecs, usecs);
+    slowest->totalUsecs += usecs;
+    slowest->lastSeen = now;
+}
+
+/*!
+  Returns the last and the largest lag in milliseconds of the event
+  loop of each thread probed, keyed by thread name.
+*/
+QVariantMap VoiceCallApplication::eventLoopLatencies() const
+{
+    TRACE
+    Q_D(const VoiceCallApplication);
+    QMutexLocker locker(&d->lock);
+    QVariantMap result;
+    foreach (const EventLoopProbe *probe, d->probes)
+        result.insert(probe->objectName(), probe->latency());
+    return result;
+}
+
+/*!
+  Returns the slowest offenders of the last hour, slowest first, with
+  how often, how long at most and in total in µs, and when last they
+  took long.
+*/
+QVariantList VoiceCallApplication::slowDispatches() const
+{
+    TRACE
+    Q_D(const VoiceCallApplication);
+    QList<Offender> offenders;
+    {
+        QMutexLocker locker(&d->lock);
+        const_cast<VoiceCallApplicationPrivate *>(d)->expire(QDateTime::currentMSecsSinceEpoch());
+        offenders = d->offenders;
+    }
+    std::sort(offenders.begin(), offenders.end(), [] (const Offender &a, const Offender &b) {
+        return a.maxUsecs > b.maxUsecs;
+    });
+
+    QVariantList result;
+    foreach (const Offender &offender, offenders) {
+        QVariantMap entry;
+        entry.insert(QStringLiteral("name"), offender.name);
+        entry.insert(QStringLiteral("count"), offender.count);
+        entry.insert(QStringLiteral("max"), offender.maxUsecs);
+        entry.insert(QStringLiteral("total"), offender.totalUsecs);
+        entry.insert(QStringLiteral("lastSeen"), QDateTime::fromMSecsSinceEpoch(offender.lastSeen));
+        result.append(entry);
+    }
+    return result;
+}
+
+void VoiceCallApplication::resetSlowDispatches()
+{
+    TRACE
+    Q_D(VoiceCallApplication);
+    QMutexLocker locker(&d->lock);
+    d->offenders.clear();
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef VOICECALLAPPLICATION_H
+#define VOICECALLAPPLICATION_H
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+
+/*
+  Measures how late a periodic timer fires in the thread the probe
+  lives in, which is the latency its event loop adds to any event.
+  It only runs when told to, not to wake up idle threads.
+*/
+class EventLoopProbe : public QObject
+{
+public:
+    explicit EventLoopProbe(const QString &name);
+
+    // Thread-safe, takes effect in the thread of the probe.
+    void setRunning(bool running);
+
+    QVariantMap latency() const;
+
+private:
+    void probe();
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QAtomicInt m_lag;
+    QAtomicInt m_maxLag;
+};
+
+class VoiceCallApplication : public QCoreApplication
+{
+    Q_OBJECT
+
+public:
+    // Times a piece of work that is not an event of its own.
+    class Scope
+    {
+    public:
+        explicit Scope(const char *what, const QString &who = QString())
+            : m_what(what), m_who(who)
+        {
+            m_clock.start();
+        }
+        ~Scope();
+
+    private:
+        const char *m_what;
+        QString m_who;
+        QElapsedTimer m_clock;
+    };
+
+    VoiceCallApplication(int &argc, char **argv);
+    ~VoiceCallApplication();
+
+    static VoiceCallApplication *instance();
+
+    bool notify(QObject *receiver, QEvent *event);
+
+    void addProbe(EventLoopProbe *probe);
+    void removeProbe(EventLoopProbe *probe);
+
+    void setBusy(bool busy);
+    void requestStallReport();
+
+    void record(const QString &name, qint64 usecs);
+
+    QVariantMap eventLoopLatencies() const;
+    QVariantList slowDispatches() const;
+    void resetSlowDispatches();
+
+private:
+    class VoiceCallApplicationPrivate *d_ptr;
+
+    Q_DECLARE_PRIVATE(VoiceCallApplication)
+};
+
+#endif // VOICECALLAPPLICATION_H
@@ -0,0 +1,284 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "common.h"
+#include "voicecalllifecycletracer.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+namespace {
+
+// Stages aggregated into histograms, from the first event to the second.
+const struct {
+    const char *from;
+    const char *to;
+} Stages[] = {
+    // Incoming calls.
+    { "added", "filtered" },
+    { "filtered", "ringtone" },
+    { "added", "ringtone" },
+    { "ringtone", "answer" },
+    { "answer", "active" },
+    { "added", "active" },
+    // Outgoing calls.
+    { "dial", "added" },
+    { "added", "alerting" },
+    { "dial", "alerting" },
+    { "alerting", "active" },
+    // Time taken by the manager to broadcast a new call.
+    { "added", "broadcast" },
+};
+
+const int BucketCount = 24;
+// A dial request not followed by a call by then is left out.
+const qint64 MaxDialDelay = 10000000000LL;
+const int KeptTimelines = 16;
+
+struct Histogram {
+    quint64 count = 0;
+    quint64 sum = 0;
+    quint64 max = 0;
+    quint32 buckets[BucketCount] = {};
+
+    void record(quint64 usecs)
+    {
+        count++;
+        sum += usecs;
+        max = qMax(max, usecs);
+        int bucket = 0;
+        for (quint64 value = usecs; value && bucket < BucketCount - 1; value >>= 1)
+            bucket++;
+        buckets[bucket]++;
+    }
+};
+
+struct Timeline {
+    QString handlerId;
+    QString providerId;
+    bool incoming = false;
+    bool emergency = false;
+    QVector<QPair<QString, qint64> > events; // Event and monotonic time in ns.
+
+    qint64 stamp(const QString &event) const
+    {
+        for (const QPair<QString, qint64> &entry : events) {
+            if (entry.first == event)
+                return entry.second;
+        }
+        return -1;
+    }
+};
+
+}
+
+/*!
+  \class VoiceCallLifecycleTracer
+  \brief Stamps the lifecycle events of calls and aggregates stage latencies.
+
+  Events are stamped with a monotonic clock, only their first occurrence
+  per call is kept. Whenever an event closes one of the known stages,
+  the time since the stage opening event goes to the stage histogram,
+  in power of two buckets of microseconds. Emergency calls have their
+  own set of histograms. The timelines of the last ended calls are kept
+  for inspection.
+*/
+class VoiceCallLifecycleTracerPrivate
+{
+    Q_DECLARE_PUBLIC(VoiceCallLifecycleTracer)
+
+public:
+    VoiceCallLifecycleTracerPrivate(VoiceCallLifecycleTracer *q)
+        : q_ptr(q)
+    {
+        clock.start();
+    }
+
+    VoiceCallLifecycleTracer *q_ptr;
+
+    QElapsedTimer clock;
+    QHash<QString, qint64> dials;
+    QHash<QString, Timeline> calls;
+    QList<Timeline> ended;
+    QHash<QString, Histogram> histograms;
+};
+
+VoiceCallLifecycleTracer::VoiceCallLifecycleTracer()
+    : d_ptr(new VoiceCallLifecycleTracerPrivate(this))
+{
+}
+
+VoiceCallLifecycleTracer::~VoiceCallLifecycleTracer()
+{
+    delete d_ptr;
+}
+
+/*!
+  Records a dial request on \a providerId, opening the timeline of the
+  next outgoing call of that provider.
+*/
+void VoiceCallLifecycleTracer::dial(const QString &providerId)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    d->dials.insert(providerId, d->clock.nsecsElapsed());
+}
+
+// Drops the dial request on \a providerId, it was refused.
+void VoiceCallLifecycleTracer::cancelDial(const QString &providerId)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    d->dials.remove(providerId);
+}
+
+void VoiceCallLifecycleTracer::begin(const QString &handlerId, const QString &providerId, bool incoming, bool emergency)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    if (d->calls.contains(handlerId))
+        return;
+
+    Timeline &timeline = d->calls[handlerId];
+    timeline.handlerId = handlerId;
+    timeline.providerId = providerId;
+    timeline.incoming = incoming;
+    timeline.emergency = emergency;
+    if (!incoming && d->dials.contains(providerId)) {
+        const qint64 dialed = d->dials.take(providerId);
+        if (d->clock.nsecsElapsed() - dialed <= MaxDialDelay)
+            timeline.events.append(qMakePair(QStringLiteral("dial"), dialed));
+    }
+    mark(handlerId, QStringLiteral("added"));
+}
+
+/*!
+  Counts the stages of \a handlerId still to come as emergency ones,
+  for calls known to be emergency calls only once they began.
+*/
+void VoiceCallLifecycleTracer::setEmergency(const QString &handlerId)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    QHash<QString, Timeline>::iterator it = d->calls.find(handlerId);
+    if (it != d->calls.end())
+        it->emergency = true;
+}
+
+void VoiceCallLifecycleTracer::mark(const QString &handlerId, const QString &event)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    QHash<QString, Timeline>::iterator it = d->calls.find(handlerId);
+    if (it == d->calls.end() || it->stamp(event) >= 0)
+        return;
+
+    const qint64 now = d->clock.nsecsElapsed();
+    it->events.append(qMakePair(event, now));
+
+    for (const auto &stage : Stages) {
+        if (event != QLatin1String(stage.to))
+            continue;
+        const qint64 from = it->stamp(QLatin1String(stage.from));
+        if (from >= 0) {
+            const QString name = (it->emergency ? QStringLiteral("emergency:") : QString())
+                + QLatin1String(stage.from) + QLatin1Char('-') + QLatin1String(stage.to);
+            d->histograms[name].record((now - from) / 1000);
+        }
+    }
+}
+
+void VoiceCallLifecycleTracer::end(const QString &handlerId)
+{
+    Q_D(VoiceCallLifecycleTracer);
+    QHash<QString, Timeline>::iterator it = d->calls.find(handlerId);
+    if (it == d->calls.end())
+        return;
+
+    d->ended.append(*it);
+    d->calls.erase(it);
+    while (d->ended.count() > KeptTimelines)
+        d->ended.removeFirst();
+}
+
+/*!
+  Returns the stage histograms, keyed by "<from>-<to>" event names,
+  prefixed by "emergency:" for emergency calls. Each
+  holds the "count" of samples, their "sum" and "max" in microseconds and
+  the "buckets" list, bucket i counting latencies below 2^i microseconds
+  and from 2^(i-1).
+*/
+QVariantMap VoiceCallLifecycleTracer::statistics() const
+{
+    Q_D(const VoiceCallLifecycleTracer);
+    QVariantMap results;
+    for (QHash<QString, Histogram>::const_iterator it = d->histograms.constBegin();
+         it != d->histograms.constEnd(); ++it) {
+        QVariantList buckets;
+        for (quint32 bucket : it->buckets)
+            buckets.append(bucket);
+
+        QVariantMap histogram;
+        histogram.insert(QStringLiteral("count"), it->count);
+        histogram.insert(QStringLiteral("sum"), it->sum);
+        histogram.insert(QStringLiteral("max"), it->max);
+        histogram.insert(QStringLiteral("buckets"), buckets);
+        results.insert(it.key(), histogram);
+    }
+    return results;
+}
+
+/*!
+  Returns the timelines of the ongoing calls followed by the last ended
+  ones. Each has the "handlerId", "providerId", "incoming" and
+  "emergency" of the call, and its "events" as a list of maps giving the
+  "event" name and its "offset" in microseconds from the first event.
+*/
+QVariantList VoiceCallLifecycleTracer::timelines() const
+{
+    Q_D(const VoiceCallLifecycleTracer);
+    QVariantList results;
+    const QList<Timeline> timelines = d->calls.values() + d->ended;
+    for (const Timeline &timeline : timelines) {
+        QVariantList events;
+        const qint64 origin = timeline.events.isEmpty() ? 0 : timeline.events.first().second;
+        for (const QPair<QString, qint64> &entry : timeline.events) {
+            QVariantMap event;
+            event.insert(QStringLiteral("event"), entry.first);
+            event.insert(QStringLiteral("offset"), (entry.second - origin) / 1000);
+            events.append(event);
+        }
+
+        QVariantMap result;
+        result.insert(QStringLiteral("handlerId"), timeline.handlerId);
+        result.insert(QStringLiteral("providerId"), timeline.providerId);
+        result.insert(QStringLiteral("incoming"), timeline.incoming);
+        result.insert(QStringLiteral("emergency"), timeline.emergency);
+        result.insert(QStringLiteral("events"), events);
+        results.append(result);
+    }
+    return results;
+}
+
+void VoiceCallLifecycleTracer::reset()
+{
+    Q_D(VoiceCallLifecycleTracer);
+    d->histograms.clear();
+    d->ended.clear();
+}
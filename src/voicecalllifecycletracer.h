@@ -0,0 +1,53 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef VOICECALLLIFECYCLETRACER_H
+#define VOICECALLLIFECYCLETRACER_H
+
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+class VoiceCallLifecycleTracer
+{
+public:
+    VoiceCallLifecycleTracer();
+    ~VoiceCallLifecycleTracer();
+
+    void dial(const QString &providerId);
+    void cancelDial(const QString &providerId);
+    void begin(const QString &handlerId, const QString &providerId, bool incoming, bool emergency = false);
+    void setEmergency(const QString &handlerId);
+    void mark(const QString &handlerId, const QString &event);
+    void end(const QString &handlerId);
+
+    QVariantMap statistics() const;
+    QVariantList timelines() const;
+    void reset();
+
+private:
+    class VoiceCallLifecycleTracerPrivate *d_ptr;
+
+    Q_DISABLE_COPY(VoiceCallLifecycleTracer)
+    Q_DECLARE_PRIVATE(VoiceCallLifecycleTracer)
+};
+
+#endif // VOICECALLLIFECYCLETRACER_H
@@ -20,10 +20,18 @@
  */
 #include "common.h"
 #include "voicecallmanager.h"
+#include "calldurationcounters.h"
+#include "livecallsnapshot.h"
+#include "voicecallapplication.h"
+#include "voicecallhandlerid.h"
+#include "voicecalllifecycletracer.h"
 
+#include <QCoreApplication>
 #include <QHash>
-#include <QUuid>
+#include <QMutex>
+#include <QPointer>
 #include <QSettings>
+#include <QTimer>
 
 #ifdef WITH_NEMO_DEVICELOCK
 #include <nemo-devicelock/devicelock.h>
@@ -33,6 +41,14 @@
 #include "audiocallpolicyproxy.h"
 #endif
 
+namespace {
+// Deferred work runs anyway when a call takes that long to set up,
+// e.g. waiting for a filter over D-Bus.
+const int MaxDeferral = 5000;
+// Ids handed out to providers that no call was added with yet.
+const int MaxPendingIds = 16;
+}
+
 class VoiceCallManagerPrivate
 {
     Q_DECLARE_PUBLIC(VoiceCallManager)
@@ -49,6 +65,384 @@ public:
 
     QHash<QString, AbstractVoiceCallHandler*> voiceCalls;
 
+    // Registry views, maintained on add, remove and status change so
+    // that queries neither walk the providers nor allocate. Lists are
+    // implicitly shared, a copy handed out stays a stable snapshot.
+    struct RegistryEntry {
+        // Keeps the id interned, with its object path, while the call lives.
+        VoiceCallHandlerId id;
+        QString providerId;
+        AbstractVoiceCallHandler::VoiceCallStatus status;
+    };
+    QList<AbstractVoiceCallHandler*> voiceCallList;
+    QHash<AbstractVoiceCallHandler*, RegistryEntry> registry;
+    // Interned ids handed out for calls not registered yet, by their
+    // string, so that they are neither parsed again nor freed meanwhile.
+    // Registered calls keep theirs in the registry, removed ones in the
+    // snapshots of the change set.
+    QHash<QString, VoiceCallHandlerId> handlerIds;
+    QList<VoiceCallHandlerId> pendingIds;
+    QHash<QString, QList<AbstractVoiceCallHandler*> > voiceCallsByProvider;
+    QHash<int, QList<AbstractVoiceCallHandler*> > voiceCallsByStatus;
+
+    void registerVoiceCall(AbstractVoiceCallHandler *handler)
+    {
+        if (registry.contains(handler))
+            return;
+
+        RegistryEntry entry;
+        entry.id = handlerIds.take(handler->handlerId());
+        if (entry.id.isNull()) {
+            // Providers may come with ids of their own.
+            entry.id = VoiceCallHandlerId::fromString(handler->handlerId());
+        } else {
+            pendingIds.removeOne(entry.id);
+        }
+        entry.providerId = handler->provider()->providerId();
+        entry.status = handler->status();
+        registry.insert(handler, entry);
+        voiceCallList.append(handler);
+        voiceCallsByProvider[entry.providerId].append(handler);
+        voiceCallsByStatus[int(entry.status)].append(handler);
+    }
+
+    void addPendingId(const VoiceCallHandlerId &id)
+    {
+        handlerIds.insert(id.toString(), id);
+        pendingIds.append(id);
+        if (pendingIds.count() > MaxPendingIds) {
+            const VoiceCallHandlerId oldest = pendingIds.first();
+            dropPendingId(oldest);
+        }
+    }
+
+    void dropPendingId(const VoiceCallHandlerId &id)
+    {
+        if (pendingIds.removeOne(id))
+            handlerIds.remove(id.toString());
+    }
+
+    // A snapshot of a registered call, with the id interned for it.
+    VoiceCallSnapshot snapshotOf(AbstractVoiceCallHandler *handler) const
+    {
+        VoiceCallSnapshot snapshot = VoiceCallSnapshot::of(handler);
+        QHash<AbstractVoiceCallHandler*, RegistryEntry>::const_iterator it = registry.constFind(handler);
+        if (it != registry.constEnd())
+            snapshot.id = it->id;
+        return snapshot;
+    }
+
+    void unregisterVoiceCall(AbstractVoiceCallHandler *handler)
+    {
+        QHash<AbstractVoiceCallHandler*, RegistryEntry>::iterator it = registry.find(handler);
+        if (it == registry.end())
+            return;
+
+        voiceCallList.removeOne(handler);
+        removeFromIndex(&voiceCallsByProvider, it->providerId, handler);
+        removeFromIndex(&voiceCallsByStatus, int(it->status), handler);
+        registry.erase(it);
+    }
+
+    void updateStatus(AbstractVoiceCallHandler *handler)
+    {
+        QHash<AbstractVoiceCallHandler*, RegistryEntry>::iterator it = registry.find(handler);
+        if (it == registry.end() || it->status == handler->status())
+            return;
+
+        removeFromIndex(&voiceCallsByStatus, int(it->status), handler);
+        it->status = handler->status();
+        voiceCallsByStatus[int(it->status)].append(handler);
+    }
+
+    // Changes are collected until the event loop gets back to the
+    // timer and committed as one change set.
+    VoiceCallChangeSet changes;
+    QTimer changeSetTimer;
+    bool legacySignals;
+
+    void scheduleChangeSet()
+    {
+        if (!changeSetTimer.isActive())
+            changeSetTimer.start();
+    }
+
+    void voiceCallAdded(const QString &handlerId)
+    {
+        // A call coming back under the same id is reported as changed.
+        if (changes.removed.removeOne(handlerId))
+            changes.changed[handlerId] |= VoiceCallChangeSet::PROPERTY_ALL;
+        else
+            changes.added.append(handlerId);
+        scheduleChangeSet();
+    }
+
+    /*
+      Takes a call out of the registry for good, accounting for its
+      duration. The change set gets its final snapshot, the handler
+      may be gone by the time the change set is committed.
+    */
+    void removeVoiceCall(AbstractVoiceCallHandler *handler)
+    {
+        Q_Q(VoiceCallManager);
+        const QString handlerId = handler->handlerId();
+        changes.snapshots.insert(handlerId, snapshotOf(handler));
+        voiceCalls.remove(handlerId);
+        if (voiceCalls.isEmpty() && VoiceCallApplication::instance())
+            VoiceCallApplication::instance()->setBusy(false);
+        unregisterVoiceCall(handler);
+        tracer.mark(handlerId, QStringLiteral("removed"));
+        tracer.end(handlerId);
+        snapshot.remove(handlerId);
+        QObject::disconnect(handler, 0, q, 0);
+        voiceCallRemoved(handlerId);
+        scheduleDeferred();
+
+        emit q->voiceCallRemoved(handlerId);
+        if (legacySignals)
+            emit q->voiceCallsChanged();
+
+        AbstractVoiceCallHandler *preempted = emergencyCall == handler ? endEmergencyLane() : NULL;
+        if (activeVoiceCall && activeVoiceCall->handlerId() == handlerId) {
+            activeVoiceCall = preempted;
+            activeVoiceCallChanged();
+            if (legacySignals)
+                emit q->activeVoiceCallChanged();
+        }
+
+        // Update call time statistics
+        counters.add(handler->provider()->providerId(), handler->isIncoming(), handler->duration());
+        if (handler->isIncoming()) {
+            DEBUG_T("Incoming call ended. Total incoming duration is now %d", counters.incoming());
+            emit q->totalIncomingCallDurationChanged();
+        } else {
+            DEBUG_T("Outgoing call ended. Total outgoing duration is now %d", counters.outgoing());
+            emit q->totalOutgoingCallDurationChanged();
+        }
+    }
+
+    // A call added within the same turn stays listed as added as well.
+    void voiceCallRemoved(const QString &handlerId)
+    {
+        changes.changed.remove(handlerId);
+        changes.removed.append(handlerId);
+        scheduleChangeSet();
+    }
+
+    // Plugins may need each status a call went through, not the latest only.
+    void statusChanged(AbstractVoiceCallHandler *handler)
+    {
+        changes.statuses[handler->handlerId()].append(handler->status());
+    }
+
+    void propertyChanged(AbstractVoiceCallHandler *handler, VoiceCallChangeSet::Property property)
+    {
+        changes.changed[handler->handlerId()] |= property;
+        // Providers may only learn late that a call is an emergency one.
+        if (property == VoiceCallChangeSet::PROPERTY_EMERGENCY && handler->isEmergency()) {
+            Q_Q(VoiceCallManager);
+            tracer.setEmergency(handler->handlerId());
+            const bool wasActive = activeVoiceCall == handler;
+            emergencyLane(handler);
+            if (!wasActive && legacySignals)
+                emit q->activeVoiceCallChanged();
+        } else {
+            scheduleChangeSet();
+        }
+    }
+
+    /*
+      Emergency calls take the audio and are broadcast at once, before
+      the plugins get to know about them through voiceCallAdded(), so
+      their latency does not depend on what the plugins do with calls.
+      The active call and routing they took over are given back by
+      endEmergencyLane() once the call is removed.
+    */
+    void emergencyLane(AbstractVoiceCallHandler *handler)
+    {
+        Q_Q(VoiceCallManager);
+        if (!emergencyCall) {
+            emergencyCall = handler;
+            preemptedVoiceCall = activeVoiceCall != handler ? activeVoiceCall : NULL;
+        }
+        if (activeVoiceCall != handler) {
+            activeVoiceCall = handler;
+            activeVoiceCallChanged();
+        }
+        if (!isAudioRouted) {
+            emergencyRouted = true;
+            q->setAudioRouted(true);
+        }
+        q->commitChangeSet();
+        scheduleDeferred();
+    }
+
+    // Returns the call to make active again, if it is still there.
+    AbstractVoiceCallHandler *endEmergencyLane()
+    {
+        Q_Q(VoiceCallManager);
+        AbstractVoiceCallHandler *preempted = preemptedVoiceCall;
+        emergencyCall.clear();
+        preemptedVoiceCall.clear();
+        if (emergencyRouted) {
+            emergencyRouted = false;
+            q->setAudioRouted(false);
+        }
+        return preempted && registry.contains(preempted) ? preempted : NULL;
+    }
+
+    QPointer<AbstractVoiceCallHandler> emergencyCall;
+    QPointer<AbstractVoiceCallHandler> preemptedVoiceCall;
+    bool emergencyRouted = false;
+
+    /*
+      Work of deferred plugins waits while a call is being filtered or
+      dialed, so that plugins storing history or updating statistics do
+      not stand between a call and its ringtone. It never waits while
+      there is an emergency call, MCE among others being deferred.
+    */
+    struct DeferredTask {
+        QPointer<AbstractVoiceCallManagerPlugin> plugin;
+        std::function<void ()> task;
+    };
+    QList<DeferredTask> deferred;
+    QTimer deferredTimer;
+
+    bool isSettingUp() const
+    {
+        if (!voiceCallsByStatus.contains(AbstractVoiceCallHandler::STATUS_NULL)
+                && !voiceCallsByStatus.contains(AbstractVoiceCallHandler::STATUS_DIALING))
+            return false;
+        foreach (AbstractVoiceCallHandler *handler, voiceCallList) {
+            if (handler->isEmergency())
+                return false;
+        }
+        return true;
+    }
+
+    void scheduleDeferred()
+    {
+        if (deferred.isEmpty())
+            return;
+        if (!isSettingUp())
+            deferredTimer.start(0);
+        else if (!deferredTimer.isActive())
+            deferredTimer.start(MaxDeferral);
+    }
+
+    void runDeferred()
+    {
+        // Tasks queued meanwhile wait for the next turn.
+        QList<DeferredTask> tasks;
+        tasks.swap(deferred);
+        foreach (const DeferredTask &task, tasks) {
+            if (task.plugin) {
+                VoiceCallApplication::Scope scope("deferred task", task.plugin->pluginId());
+                task.task();
+            }
+        }
+        scheduleDeferred();
+    }
+
+    /*
+      Runs the work still pending once the event loop is left, before
+      the plugins are finalized: the last change set, the commands of
+      plugins and the deferred tasks, along with what those post to
+      their plugins.
+    */
+    void flush()
+    {
+        Q_Q(VoiceCallManager);
+        q->commitChangeSet();
+        do {
+            q->runCommands();
+            QList<QPointer<AbstractVoiceCallManagerPlugin> > plugins;
+            foreach (const DeferredTask &task, deferred)
+                plugins.append(task.plugin);
+            runDeferred();
+            foreach (const QPointer<AbstractVoiceCallManagerPlugin> &plugin, plugins) {
+                if (plugin)
+                    QCoreApplication::sendPostedEvents(plugin, QEvent::MetaCall);
+            }
+        } while (!deferred.isEmpty() || hasCommands());
+        deferredTimer.stop();
+    }
+
+    bool hasCommands()
+    {
+        QMutexLocker locker(&commandsLock);
+        return !commands.isEmpty();
+    }
+
+    // Filled from any thread, see invoke().
+    QMutex commandsLock;
+    QList<std::function<void (VoiceCallManagerInterface *)> > commands;
+
+    void activeVoiceCallChanged()
+    {
+        changes.activeVoiceCallChanged = true;
+        scheduleChangeSet();
+    }
+
+    template <typename Signal>
+    void watch(AbstractVoiceCallHandler *handler, Signal signal, VoiceCallChangeSet::Property property)
+    {
+        QObject::connect(handler, signal, q_ptr, [this, handler, property] () {
+            propertyChanged(handler, property);
+        });
+    }
+
+    void watchProperties(AbstractVoiceCallHandler *handler)
+    {
+        // Status changes are tracked by onVoiceCallStatusChanged().
+        watch(handler, &AbstractVoiceCallHandler::lineIdChanged, VoiceCallChangeSet::PROPERTY_LINE_ID);
+        watch(handler, &AbstractVoiceCallHandler::startedAtChanged, VoiceCallChangeSet::PROPERTY_STARTED_AT);
+        watch(handler, &AbstractVoiceCallHandler::durationChanged, VoiceCallChangeSet::PROPERTY_DURATION);
+        watch(handler, &AbstractVoiceCallHandler::emergencyChanged, VoiceCallChangeSet::PROPERTY_EMERGENCY);
+        watch(handler, &AbstractVoiceCallHandler::multipartyChanged, VoiceCallChangeSet::PROPERTY_MULTIPARTY);
+        watch(handler, &AbstractVoiceCallHandler::forwardedChanged, VoiceCallChangeSet::PROPERTY_FORWARDED);
+        watch(handler, &AbstractVoiceCallHandler::remoteHeldChanged, VoiceCallChangeSet::PROPERTY_REMOTE_HELD);
+        watch(handler, &AbstractVoiceCallHandler::parentHandlerIdChanged, VoiceCallChangeSet::PROPERTY_PARENT_HANDLER_ID);
+        watch(handler, &AbstractVoiceCallHandler::childCallsChanged, VoiceCallChangeSet::PROPERTY_CHILD_CALLS);
+    }
+
+    void traceStatus(AbstractVoiceCallHandler *handler)
+    {
+        const AbstractVoiceCallHandler::VoiceCallStatus status = handler->status();
+        if (status == AbstractVoiceCallHandler::STATUS_NULL)
+            return;
+
+        // Leaving the NULL state is the outcome of filtering.
+        if (handler->isIncoming())
+            tracer.mark(handler->handlerId(), QStringLiteral("filtered"));
+
+        switch (status) {
+        case AbstractVoiceCallHandler::STATUS_ALERTING:
+            tracer.mark(handler->handlerId(), QStringLiteral("alerting"));
+            break;
+        case AbstractVoiceCallHandler::STATUS_ACTIVE:
+            tracer.mark(handler->handlerId(), QStringLiteral("active"));
+            break;
+        case AbstractVoiceCallHandler::STATUS_DISCONNECTED:
+            tracer.mark(handler->handlerId(), QStringLiteral("disconnected"));
+            break;
+        default:
+            break;
+        }
+    }
+
+    template <typename Key>
+    static void removeFromIndex(QHash<Key, QList<AbstractVoiceCallHandler*> > *index,
+                                const Key &key, AbstractVoiceCallHandler *handler)
+    {
+        typename QHash<Key, QList<AbstractVoiceCallHandler*> >::iterator it = index->find(key);
+        if (it == index->end())
+            return;
+        it->removeOne(handler);
+        if (it->isEmpty())
+            index->erase(it);
+    }
+
     AbstractVoiceCallHandler *activeVoiceCall;
 
 #ifdef WITH_NEMO_DEVICELOCK
@@ -61,6 +455,10 @@ public:
     bool isSpeakerMuted;
     bool isCallFiltering = false;
 
+    CallDurationCounters counters;
+    LiveCallSnapshot snapshot;
+    VoiceCallLifecycleTracer tracer;
+
     QString errorString;
 };
 
@@ -68,6 +466,21 @@ VoiceCallManager::VoiceCallManager(QObject *parent)
     : VoiceCallManagerInterface(parent), d_ptr(new VoiceCallManagerPrivate(this))
 {
     TRACE
+    Q_D(VoiceCallManager);
+    // voiceCallsChanged() and activeVoiceCallChanged() are kept for
+    // plugins not following changeSetCommitted() yet.
+    d->legacySignals = legacySignals();
+    // Plugins in their own thread get the change sets queued.
+    qRegisterMetaType<VoiceCallChangeSet>();
+
+    d->changeSetTimer.setSingleShot(true);
+    d->changeSetTimer.setInterval(0);
+    QObject::connect(&d->changeSetTimer, SIGNAL(timeout()), SLOT(commitChangeSet()));
+
+    d->deferredTimer.setSingleShot(true);
+    QObject::connect(&d->deferredTimer, &QTimer::timeout, this, [d] () { d->runDeferred(); });
+    if (QCoreApplication::instance())
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [d] () { d->flush(); });
 }
 
 VoiceCallManager::~VoiceCallManager()
@@ -153,42 +566,113 @@ void VoiceCallManager::removeProvider(AbstractVoiceCallProvider *provider)
                         this,
                         SLOT(setError(QString)));
 
+    // Calls of a gone provider would otherwise linger in the registry,
+    // the provider keeps ownership of their handlers.
+    foreach (AbstractVoiceCallHandler *handler, d->voiceCallsByProvider.value(provider->providerId()))
+        d->removeVoiceCall(handler);
+
     d->providers.remove(provider->providerId());
     emit this->providersChanged();
     emit this->providerRemoved(provider->providerId());
 }
 
+/*!
+  Whether the signals superseded by change sets and by PropertiesChanged
+  on D-Bus are still sent, for plugins and clients not following those
+  yet. That is voiceCallsChanged() and activeVoiceCallChanged() of the
+  manager, and the per property signals of its D-Bus interfaces.
+
+  Read once from the legacySignals key of the settings, off by default.
+*/
+bool VoiceCallManager::legacySignals()
+{
+    static const bool on = QSettings().value(QStringLiteral("legacySignals"), false).toBool();
+    return on;
+}
+
+/*!
+  Returns a new handler id. It is kept interned until the call it is
+  used for is removed, or until a few more ids are handed out if it is
+  not used.
+*/
 QString VoiceCallManager::generateHandlerId()
 {
     TRACE
-    QString handlerId = QUuid::createUuid().toString().mid(1, 36); // Remove curly braces.
-    return handlerId.replace('-', ""); // Remove dashes, (can't have dashes in dbus paths)
+    Q_D(VoiceCallManager);
+    // Hex digits only, dashes cannot be part of D-Bus paths.
+    const VoiceCallHandlerId id = VoiceCallHandlerId::generate();
+    d->addPendingId(id);
+    return id.toString();
+}
+
+/*!
+  Returns the handler id for the call at \a path of \a providerId,
+  along with what was known of it if the manager restarted meanwhile
+  and the call still goes to \a lineId, started at \a startedAt when
+  known.
+*/
+VoiceCallManagerInterface::ReclaimedVoiceCall VoiceCallManager::reclaimVoiceCall(const QString &providerId, const QString &path,
+                                                                                 const QString &lineId, const QDateTime &startedAt)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    const QString generated = generateHandlerId();
+    const ReclaimedVoiceCall reclaimed = d->snapshot.reclaim(providerId, path, lineId, startedAt, generated);
+    if (reclaimed.handlerId != generated) {
+        d->dropPendingId(d->handlerIds.value(generated));
+        const VoiceCallHandlerId id = VoiceCallHandlerId::fromString(reclaimed.handlerId);
+        if (!id.isNull())
+            d->addPendingId(id);
+    }
+    if (reclaimed.isReclaimed)
+        DEBUG_T("VCM: reclaimed call %s at %s", qPrintable(reclaimed.handlerId), qPrintable(path));
+    return reclaimed;
 }
 
 int VoiceCallManager::voiceCallCount() const
 {
     TRACE
     Q_D(const VoiceCallManager);
-    int result = 0;
+    return d->voiceCallList.count();
+}
 
-    foreach (AbstractVoiceCallProvider *provider, d->providers.values()) {
-        result += provider->voiceCalls().length();
-    }
+QList<AbstractVoiceCallHandler*> VoiceCallManager::voiceCalls() const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->voiceCallList;
+}
 
-    return result;
+AbstractVoiceCallHandler* VoiceCallManager::voiceCall(const QString &handlerId) const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->voiceCalls.value(handlerId);
 }
 
-QList<AbstractVoiceCallHandler*> VoiceCallManager::voiceCalls() const
+VoiceCallHandlerId VoiceCallManager::voiceCallHandlerId(const QString &handlerId) const
 {
     TRACE
     Q_D(const VoiceCallManager);
-    QList<AbstractVoiceCallHandler*> results;
+    QHash<AbstractVoiceCallHandler*, VoiceCallManagerPrivate::RegistryEntry>::const_iterator it
+            = d->registry.constFind(d->voiceCalls.value(handlerId));
+    if (it != d->registry.constEnd())
+        return it->id;
+    return d->handlerIds.value(handlerId);
+}
 
-    foreach (AbstractVoiceCallProvider *provider, d->providers) {
-        results.append(provider->voiceCalls());
-    }
+QList<AbstractVoiceCallHandler*> VoiceCallManager::voiceCallsWithStatus(AbstractVoiceCallHandler::VoiceCallStatus status) const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->voiceCallsByStatus.value(int(status));
+}
 
-    return results;
+QList<AbstractVoiceCallHandler*> VoiceCallManager::voiceCallsForProvider(const QString &providerId) const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->voiceCallsByProvider.value(providerId);
 }
 
 QString VoiceCallManager::audioMode() const
@@ -298,7 +782,12 @@ bool VoiceCallManager::dial(const QString &providerId, const QString &msisdn)
         return false;
     }
 
-    return provider->dial(msisdn);
+    d->tracer.dial(providerId);
+    if (!provider->dial(msisdn)) {
+        d->tracer.cancelDial(providerId);
+        return false;
+    }
+    return true;
 }
 
 void VoiceCallManager::setCallFiltering(bool on)
@@ -308,6 +797,87 @@ void VoiceCallManager::setCallFiltering(bool on)
     d->isCallFiltering = on;
 }
 
+/*!
+  Stamps \a event in the lifecycle of the call \a handlerId, for
+  events happening outside of the manager, like the ringtone start.
+*/
+void VoiceCallManager::traceVoiceCallEvent(const QString &handlerId, const QString &event)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    d->tracer.mark(handlerId, event);
+}
+
+/*!
+  Runs \a task right away for critical plugins. The task of a deferred
+  \a plugin is queued until no call is being filtered or dialed, and
+  dropped if the plugin is gone by then. Tasks of a plugin run in the
+  order they were scheduled. Plugins living in their own thread have
+  their tasks run right away, in that thread. Tasks still queued when
+  the event loop is left run then, before the plugins are finalized.
+*/
+void VoiceCallManager::schedule(AbstractVoiceCallManagerPlugin *plugin, const std::function<void ()> &task)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    // Plugins in their own thread do not hold up the calls anyway.
+    if (!plugin || plugin->priority() == AbstractVoiceCallManagerPlugin::PRIORITY_CRITICAL
+            || plugin->thread() != thread()) {
+        task();
+        return;
+    }
+
+    VoiceCallManagerPrivate::DeferredTask deferred;
+    deferred.plugin = plugin;
+    deferred.task = task;
+    d->deferred.append(deferred);
+    d->scheduleDeferred();
+}
+
+void VoiceCallManager::invoke(const std::function<void (VoiceCallManagerInterface *manager)> &command)
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    QMutexLocker locker(&d->commandsLock);
+    d->commands.append(command);
+    if (d->commands.count() == 1)
+        QMetaObject::invokeMethod(this, "runCommands", Qt::QueuedConnection);
+}
+
+void VoiceCallManager::runCommands()
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    QList<std::function<void (VoiceCallManagerInterface *)> > commands;
+    {
+        QMutexLocker locker(&d->commandsLock);
+        commands.swap(d->commands);
+    }
+    foreach (const std::function<void (VoiceCallManagerInterface *)> &command, commands)
+        command(this);
+}
+
+QVariantMap VoiceCallManager::lifecycleStatistics() const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->tracer.statistics();
+}
+
+QVariantList VoiceCallManager::lifecycleTimelines() const
+{
+    TRACE
+    Q_D(const VoiceCallManager);
+    return d->tracer.timelines();
+}
+
+void VoiceCallManager::resetLifecycleStatistics()
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    d->tracer.reset();
+}
+
 void VoiceCallManager::playRingtone(const QString &ringtonePath)
 {
     TRACE
@@ -357,23 +927,52 @@ void VoiceCallManager::onVoiceCallAdded(AbstractVoiceCallHandler *handler)
     }
 #endif
 
+    const bool isEmergency = handler->isEmergency();
+    d->tracer.begin(handler->handlerId(), handler->provider()->providerId(), handler->isIncoming(), isEmergency);
+
     // Incoming calls are kept in the NULL state,
     // waiting to be filtered, by a plugin or via D-Bus.
     // If no call filter was set, the manager is releasing
-    // any call.
-    if (handler->isIncoming() && !d->isCallFiltering) {
+    // any call. A call reclaimed after a restart keeps its verdict,
+    // emergency calls are never filtered.
+    AbstractVoiceCallHandler::VoiceCallFilterAction verdict;
+    if (handler->isIncoming() && isEmergency) {
+        handler->filter(AbstractVoiceCallHandler::ACTION_CONTINUE);
+    } else if (handler->isIncoming() && d->snapshot.verdict(handler->handlerId(), &verdict)) {
+        handler->filter(verdict);
+    } else if (handler->isIncoming() && !d->isCallFiltering) {
         handler->filter(AbstractVoiceCallHandler::ACTION_CONTINUE);
     }
 
     //AudioCallPolicyProxy *pHandler = new AudioCallPolicyProxy(handler, this);
     d->voiceCalls.insert(handler->handlerId(), handler);
-
-    emit this->voiceCallAdded(handler);
-    emit this->voiceCallsChanged();
-
-    if (!d->activeVoiceCall) {
+    // Event loops are watched while there are calls.
+    if (VoiceCallApplication::instance())
+        VoiceCallApplication::instance()->setBusy(true);
+    d->registerVoiceCall(handler);
+    QObject::connect(handler, SIGNAL(statusChanged(VoiceCallStatus)),
+                     SLOT(onVoiceCallStatusChanged()), Qt::UniqueConnection);
+    d->watchProperties(handler);
+    d->traceStatus(handler);
+    d->snapshot.update(handler);
+    d->voiceCallAdded(handler->handlerId());
+    d->statusChanged(handler);
+
+    if (isEmergency) {
+        d->emergencyLane(handler);
+    } else if (!d->activeVoiceCall) {
         d->activeVoiceCall = handler;
-        emit this->activeVoiceCallChanged();
+        d->activeVoiceCallChanged();
+    }
+
+    {
+        VoiceCallApplication::Scope scope("voiceCallAdded");
+        emit this->voiceCallAdded(handler);
+    }
+    if (d->legacySignals) {
+        emit this->voiceCallsChanged();
+        if (d->activeVoiceCall == handler)
+            emit this->activeVoiceCallChanged();
     }
 }
 
@@ -386,66 +985,79 @@ void VoiceCallManager::onVoiceCallRemoved(const QString &handlerId)
         DEBUG_T("VCM: attempt to remove unregistered handler: %s", qPrintable(handlerId));
         return;
     }
-    d->voiceCalls.remove(handlerId);
-
-    emit this->voiceCallRemoved(handlerId);
-    emit this->voiceCallsChanged();
+    d->removeVoiceCall(handler);
+    handler->deleteLater();
+}
 
-    if (d->activeVoiceCall && d->activeVoiceCall->handlerId() == handlerId) {
-        d->activeVoiceCall = NULL;
-        emit this->activeVoiceCallChanged();
+void VoiceCallManager::onVoiceCallStatusChanged()
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    AbstractVoiceCallHandler *handler = qobject_cast<AbstractVoiceCallHandler*>(sender());
+    if (handler) {
+        d->updateStatus(handler);
+        d->traceStatus(handler);
+        d->statusChanged(handler);
+        d->propertyChanged(handler, VoiceCallChangeSet::PROPERTY_STATUS);
+        d->scheduleDeferred();
     }
+}
+
+/*!
+  Emits the changes collected since the last event loop turn.
+*/
+void VoiceCallManager::commitChangeSet()
+{
+    TRACE
+    Q_D(VoiceCallManager);
+    if (d->changes.isEmpty())
+        return;
 
-    QSettings settings;
-    settings.beginGroup(QLatin1String("Voice Counters"));
+    VoiceCallChangeSet changes = d->changes;
+    d->changes = VoiceCallChangeSet();
+    d->changeSetTimer.stop();
 
-    // Update call time statistics
-    if (handler->isIncoming()) {
-        int received = settings.value(QLatin1String("Received")).toInt();
-        received += handler->duration();
-        DEBUG_T("Incoming call ended. Total incoming duration is now %d", received);
-        settings.setValue(QLatin1String("Received"), received);
-        emit totalIncomingCallDurationChanged();
-    } else {
-        int dialled = settings.value(QLatin1String("Dialled")).toInt();
-        dialled += handler->duration();
-        DEBUG_T("Outgoing call ended. Total outgoing duration is now %d", dialled);
-        settings.setValue(QLatin1String("Dialled"), dialled);
-        emit totalOutgoingCallDurationChanged();
+    foreach (const QString &handlerId, changes.added) {
+        AbstractVoiceCallHandler *handler = d->voiceCalls.value(handlerId);
+        if (handler)
+            changes.snapshots.insert(handlerId, d->snapshotOf(handler));
+    }
+    // The live call snapshot is brought up to date once per turn as well,
+    // durations alone are left out, they follow from the last update.
+    for (QHash<QString, VoiceCallChangeSet::Properties>::const_iterator it = changes.changed.constBegin();
+         it != changes.changed.constEnd(); ++it) {
+        AbstractVoiceCallHandler *handler = d->voiceCalls.value(it.key());
+        if (handler) {
+            if (it.value() != VoiceCallChangeSet::PROPERTY_DURATION)
+                d->snapshot.update(handler);
+            changes.snapshots.insert(it.key(), d->snapshotOf(handler));
+        }
+    }
+    {
+        VoiceCallApplication::Scope scope("changeSetCommitted");
+        emit this->changeSetCommitted(changes);
     }
 
-    settings.endGroup();
-
-    handler->deleteLater();
+    foreach (const QString &handlerId, changes.added)
+        d->tracer.mark(handlerId, QStringLiteral("broadcast"));
 }
 
 int VoiceCallManager::totalOutgoingCallDuration() const
 {
-    QSettings settings;
-    settings.beginGroup(QLatin1String("Voice Counters"));
-    int dialled = settings.value(QLatin1String("Dialled")).toInt();
-    DEBUG_T("Request for outgoing call duration. Total: %d", dialled);
-    return dialled;
+    Q_D(const VoiceCallManager);
+    return d->counters.outgoing();
 }
 
 int VoiceCallManager::totalIncomingCallDuration() const
 {
-    QSettings settings;
-    settings.beginGroup(QLatin1String("Voice Counters"));
-    int received = settings.value(QLatin1String("Received")).toInt();
-    DEBUG_T("Request for incoming call duration. Total: %d", received);
-    return received;
+    Q_D(const VoiceCallManager);
+    return d->counters.incoming();
 }
 
 void VoiceCallManager::resetCallDurationCounters()
 {
-    {
-        QSettings settings;
-        settings.beginGroup(QLatin1String("Voice Counters"));
-        settings.setValue(QLatin1String("Received"), 0);
-        settings.setValue(QLatin1String("Dialled"), 0);
-        settings.endGroup();
-    }
+    Q_D(VoiceCallManager);
+    d->counters.reset();
 
     emit totalOutgoingCallDurationChanged();
     emit totalIncomingCallDurationChanged();
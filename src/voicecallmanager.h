@@ -31,12 +31,20 @@ public:
     explicit VoiceCallManager(QObject *parent = 0);
     ~VoiceCallManager();
 
+    static bool legacySignals();
+
     QList<AbstractVoiceCallProvider*> providers() const;
 
     QString generateHandlerId();
+    ReclaimedVoiceCall reclaimVoiceCall(const QString &providerId, const QString &path,
+                                        const QString &lineId, const QDateTime &startedAt);
 
     int voiceCallCount() const;
     QList<AbstractVoiceCallHandler*> voiceCalls() const;
+    AbstractVoiceCallHandler* voiceCall(const QString &handlerId) const;
+    VoiceCallHandlerId voiceCallHandlerId(const QString &handlerId) const;
+    QList<AbstractVoiceCallHandler*> voiceCallsWithStatus(AbstractVoiceCallHandler::VoiceCallStatus status) const;
+    QList<AbstractVoiceCallHandler*> voiceCallsForProvider(const QString &providerId) const;
 
     AbstractVoiceCallHandler* activeVoiceCall() const;
 
@@ -51,6 +59,12 @@ public:
     int totalIncomingCallDuration() const;
     void resetCallDurationCounters();
 
+    void schedule(AbstractVoiceCallManagerPlugin *plugin, const std::function<void ()> &task);
+    void invoke(const std::function<void (VoiceCallManagerInterface *manager)> &command);
+
+    QVariantMap lifecycleStatistics() const;
+    QVariantList lifecycleTimelines() const;
+
 public Q_SLOTS:
     void setError(const QString &errorString);
 
@@ -61,6 +75,9 @@ public Q_SLOTS:
 
     void setCallFiltering(bool on = true) override;
 
+    void traceVoiceCallEvent(const QString &handlerId, const QString &event);
+    void resetLifecycleStatistics();
+
     void playRingtone(const QString &ringtonePath);
     void silenceRingtone();
 
@@ -83,6 +100,9 @@ public Q_SLOTS:
 protected Q_SLOTS:
     void onVoiceCallAdded(AbstractVoiceCallHandler *handler);
     void onVoiceCallRemoved(const QString &handlerId);
+    void onVoiceCallStatusChanged();
+    void commitChangeSet();
+    void runCommands();
 
 private:
     class VoiceCallManagerPrivate *d_ptr;
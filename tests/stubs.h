@@ -0,0 +1,115 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef STUBS_H
+#define STUBS_H
+
+#include <abstractvoicecallhandler.h>
+
+#include <QDateTime>
+
+/*
+  A call whose state is set by the test, without a provider.
+*/
+class Handler: public AbstractVoiceCallHandler
+{
+    Q_OBJECT
+public:
+    Handler(const QString &handlerId, QObject *parent = nullptr)
+        : AbstractVoiceCallHandler(parent), mHandlerId(handlerId)
+    {
+    }
+
+    AbstractVoiceCallProvider* provider() const override
+    {
+        return nullptr;
+    }
+    QString handlerId() const override
+    {
+        return mHandlerId;
+    }
+    QString lineId() const override
+    {
+        return mLineId;
+    }
+    QString subscriberId() const override
+    {
+        return QString();
+    }
+    QDateTime startedAt() const override
+    {
+        return mStartedAt;
+    }
+    int duration() const override
+    {
+        return mDuration;
+    }
+    bool isIncoming() const override
+    {
+        return mIncoming;
+    }
+    bool isMultiparty() const override
+    {
+        return false;
+    }
+    bool isEmergency() const override
+    {
+        return false;
+    }
+    bool isForwarded() const override
+    {
+        return false;
+    }
+    bool isRemoteHeld() const override
+    {
+        return false;
+    }
+    QString parentHandlerId() const override
+    {
+        return QString();
+    }
+    QList<AbstractVoiceCallHandler*> childCalls() const override
+    {
+        return QList<AbstractVoiceCallHandler*>();
+    }
+    VoiceCallStatus status() const override
+    {
+        return mStatus;
+    }
+
+    void answer() override {}
+    void hangup() override {}
+    void hold(bool on) override { Q_UNUSED(on); }
+    void deflect(const QString &target) override { Q_UNUSED(target); }
+    void sendDtmf(const QString &tones) override { Q_UNUSED(tones); }
+    void merge(const QString &callHandle) override { Q_UNUSED(callHandle); }
+    void split() override {}
+    void filter(VoiceCallFilterAction action) override { Q_UNUSED(action); }
+
+    QString mHandlerId;
+    QString mLineId;
+    QDateTime mStartedAt;
+    int mDuration = 0;
+    bool mIncoming = false;
+    VoiceCallStatus mStatus = STATUS_NULL;
+};
+
+#endif // STUBS_H
@@ -0,0 +1,14 @@
+TEMPLATE = app
+QT = core testlib
+CONFIG += c++11
+
+SRCDIR = $$PWD/../src
+INCLUDEPATH += $$PWD/../lib/src $$SRCDIR
+DEPENDPATH = $$INCLUDEPATH
+
+LIBS += -L$$PWD/../lib/src -lvoicecall
+
+HEADERS += $$PWD/stubs.h
+
+target.path = /opt/tests/voicecall/manager
+INSTALLS += target
@@ -0,0 +1,2 @@
+TEMPLATE = subdirs
+SUBDIRS = tst_livecallsnapshot.pro tst_calldurationcounters.pro
@@ -0,0 +1,173 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <calldurationcounters.h>
+
+const QString ProviderId = QStringLiteral("ofono/ril_0");
+
+class tst_calldurationcounters: public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_calldurationcounters(QObject *parent = nullptr);
+
+private slots:
+    void init();
+
+    void tst_load();
+    void tst_writeBehind();
+    void tst_flushOnDestruction();
+    void tst_keptDays();
+    void tst_corrupt();
+    void tst_newerVersion();
+
+private:
+    void writeFile(const QString &fileName, const QByteArray &data) const;
+    QByteArray readFile(const QString &fileName) const;
+
+    QScopedPointer<QTemporaryDir> mDir;
+    QString mFileName;
+};
+
+tst_calldurationcounters::tst_calldurationcounters(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void tst_calldurationcounters::init()
+{
+    mDir.reset(new QTemporaryDir);
+    QVERIFY(mDir->isValid());
+    mFileName = mDir->path() + QStringLiteral("/counters.json");
+}
+
+void tst_calldurationcounters::writeFile(const QString &fileName, const QByteArray &data) const
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+QByteArray tst_calldurationcounters::readFile(const QString &fileName) const
+{
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void tst_calldurationcounters::tst_load()
+{
+    writeFile(mFileName, "{\"version\": 1,"
+                         " \"total\": {\"incoming\": 120, \"outgoing\": 300},"
+                         " \"providers\": {\"ofono/ril_0\": {\"incoming\": 100, \"outgoing\": 200}},"
+                         " \"days\": {\"2026-10-17\": {\"incoming\": 20, \"outgoing\": 30}}}");
+
+    CallDurationCounters counters(mFileName);
+    QCOMPARE(counters.incoming(), 120);
+    QCOMPARE(counters.outgoing(), 300);
+    QCOMPARE(counters.incoming(ProviderId), 100);
+    QCOMPARE(counters.outgoing(ProviderId), 200);
+    QCOMPARE(counters.incoming(QDate(2026, 10, 17)), 20);
+    QCOMPARE(counters.outgoing(QDate(2026, 10, 17)), 30);
+}
+
+void tst_calldurationcounters::tst_writeBehind()
+{
+    const QDate day = QDate::currentDate();
+    CallDurationCounters counters(mFileName);
+    counters.add(ProviderId, true, 30, day);
+    counters.add(ProviderId, false, 40, day);
+
+    // Calls ending close to each other make a single write.
+    QVERIFY(!QFile::exists(mFileName));
+    QTRY_VERIFY(QFile::exists(mFileName));
+
+    CallDurationCounters loaded(mFileName);
+    QCOMPARE(loaded.incoming(), 30);
+    QCOMPARE(loaded.outgoing(), 40);
+    QCOMPARE(loaded.incoming(ProviderId), 30);
+    QCOMPARE(loaded.outgoing(day), 40);
+}
+
+void tst_calldurationcounters::tst_flushOnDestruction()
+{
+    {
+        CallDurationCounters counters(mFileName);
+        counters.add(ProviderId, true, 30);
+    }
+
+    CallDurationCounters loaded(mFileName);
+    QCOMPARE(loaded.incoming(), 30);
+}
+
+void tst_calldurationcounters::tst_keptDays()
+{
+    const QDate day = QDate::currentDate();
+    CallDurationCounters counters(mFileName);
+    counters.add(ProviderId, true, 30, day.addDays(-100));
+    counters.add(ProviderId, true, 40, day);
+
+    QCOMPARE(counters.incoming(day.addDays(-100)), 0);
+    QCOMPARE(counters.incoming(day), 40);
+    QCOMPARE(counters.incoming(), 70);
+}
+
+void tst_calldurationcounters::tst_corrupt()
+{
+    const QByteArray corrupt("{\"version\": 1, \"total\": {\"incoming\"");
+    writeFile(mFileName, corrupt);
+
+    CallDurationCounters counters(mFileName);
+    QCOMPARE(counters.incoming(), 0);
+    QCOMPARE(readFile(mFileName + QStringLiteral(".corrupt")), corrupt);
+
+    counters.add(ProviderId, true, 30);
+    counters.flush();
+    const QJsonObject root = QJsonDocument::fromJson(readFile(mFileName)).object();
+    QCOMPARE(root.value(QStringLiteral("total")).toObject().value(QStringLiteral("incoming")).toInt(), 30);
+}
+
+void tst_calldurationcounters::tst_newerVersion()
+{
+    const QByteArray newer("{\"version\": 2, \"total\": {\"received\": 120}}");
+    writeFile(mFileName, newer);
+
+    CallDurationCounters counters(mFileName);
+    QCOMPARE(counters.incoming(), 0);
+
+    counters.add(ProviderId, true, 30);
+    counters.flush();
+
+    // Left for the newer version to take back.
+    QCOMPARE(readFile(mFileName + QStringLiteral(".v2")), newer);
+    const QJsonObject root = QJsonDocument::fromJson(readFile(mFileName)).object();
+    QCOMPARE(root.value(QStringLiteral("version")).toInt(), 1);
+}
+
+#include "tst_calldurationcounters.moc"
+QTEST_MAIN(tst_calldurationcounters)
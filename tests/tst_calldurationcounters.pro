@@ -0,0 +1,8 @@
+include(tests.pri)
+
+TARGET = tst_calldurationcounters
+
+HEADERS += $$SRCDIR/calldurationcounters.h
+
+SOURCES += $$SRCDIR/calldurationcounters.cpp \
+    tst_calldurationcounters.cpp
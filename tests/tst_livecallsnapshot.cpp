@@ -0,0 +1,178 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QTemporaryDir>
+
+#include <livecallsnapshot.h>
+
+#include "stubs.h"
+
+typedef VoiceCallManagerInterface::ReclaimedVoiceCall Reclaimed;
+
+const QString ProviderId = QStringLiteral("ofono/ril_0");
+const QString Path = QStringLiteral("/ril_0/voicecall01");
+const QString LineId = QStringLiteral("+3581000001");
+
+class tst_livecallsnapshot: public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_livecallsnapshot(QObject *parent = nullptr);
+
+private slots:
+    void init();
+
+    void tst_newCall();
+    void tst_reclaim();
+    void tst_reusedPath_data();
+    void tst_reusedPath();
+    void tst_verdict();
+    void tst_removed();
+
+private:
+    // A call of a previous run of the manager, left in the snapshot.
+    void leaveCall(AbstractVoiceCallHandler::VoiceCallStatus status, const QDateTime &startedAt);
+
+    QScopedPointer<QTemporaryDir> mDir;
+    QString mFileName;
+};
+
+tst_livecallsnapshot::tst_livecallsnapshot(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void tst_livecallsnapshot::init()
+{
+    mDir.reset(new QTemporaryDir);
+    QVERIFY(mDir->isValid());
+    mFileName = mDir->path() + QStringLiteral("/calls.snapshot");
+}
+
+void tst_livecallsnapshot::leaveCall(AbstractVoiceCallHandler::VoiceCallStatus status,
+                                     const QDateTime &startedAt)
+{
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, QDateTime(), QStringLiteral("before"));
+    QCOMPARE(call.handlerId, QStringLiteral("before"));
+
+    Handler handler(call.handlerId);
+    handler.mLineId = LineId;
+    handler.mStartedAt = startedAt;
+    handler.mDuration = 10;
+    handler.mIncoming = true;
+    handler.mStatus = status;
+    snapshot.update(&handler);
+}
+
+void tst_livecallsnapshot::tst_newCall()
+{
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, QDateTime(), QStringLiteral("new"));
+
+    QCOMPARE(call.handlerId, QStringLiteral("new"));
+    QVERIFY(!call.isReclaimed);
+    QVERIFY(!call.startedAt.isValid());
+    QCOMPARE(call.duration, 0);
+}
+
+void tst_livecallsnapshot::tst_reclaim()
+{
+    const QDateTime startedAt = QDateTime::currentDateTime().addSecs(-10);
+    leaveCall(AbstractVoiceCallHandler::STATUS_ACTIVE, startedAt);
+
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, startedAt, QStringLiteral("after"));
+
+    QCOMPARE(call.handlerId, QStringLiteral("before"));
+    QVERIFY(call.isReclaimed);
+    QVERIFY(call.isIncoming);
+    QCOMPARE(call.startedAt, startedAt);
+    // Still counting while the manager was gone.
+    QVERIFY(call.duration >= 10);
+}
+
+void tst_livecallsnapshot::tst_reusedPath_data()
+{
+    const QDateTime startedAt = QDateTime::currentDateTime().addSecs(-10);
+
+    QTest::addColumn<QDateTime>("startedAt");
+    QTest::addColumn<QString>("lineId");
+    QTest::addColumn<QDateTime>("reclaimedAt");
+
+    QTest::newRow("other line") << startedAt << QStringLiteral("+3581000002") << startedAt;
+    QTest::newRow("other line, start unknown") << QDateTime() << QStringLiteral("+3581000002") << QDateTime();
+    QTest::newRow("started later") << startedAt << LineId << startedAt.addSecs(5);
+}
+
+void tst_livecallsnapshot::tst_reusedPath()
+{
+    QFETCH(QDateTime, startedAt);
+    QFETCH(QString, lineId);
+    QFETCH(QDateTime, reclaimedAt);
+
+    // The call ended while the manager was gone, a new one took its path.
+    leaveCall(AbstractVoiceCallHandler::STATUS_REJECTED, startedAt);
+
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, lineId, reclaimedAt, QStringLiteral("after"));
+
+    QCOMPARE(call.handlerId, QStringLiteral("after"));
+    QVERIFY(!call.isReclaimed);
+    QVERIFY(!call.isIncoming);
+    QCOMPARE(call.duration, 0);
+
+    AbstractVoiceCallHandler::VoiceCallFilterAction action;
+    QVERIFY(!snapshot.verdict(call.handlerId, &action));
+}
+
+void tst_livecallsnapshot::tst_verdict()
+{
+    leaveCall(AbstractVoiceCallHandler::STATUS_REJECTED, QDateTime());
+
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, QDateTime(), QStringLiteral("after"));
+    QCOMPARE(call.handlerId, QStringLiteral("before"));
+
+    AbstractVoiceCallHandler::VoiceCallFilterAction action = AbstractVoiceCallHandler::ACTION_CONTINUE;
+    QVERIFY(snapshot.verdict(call.handlerId, &action));
+    QCOMPARE(action, AbstractVoiceCallHandler::ACTION_REJECT);
+}
+
+void tst_livecallsnapshot::tst_removed()
+{
+    {
+        LiveCallSnapshot snapshot(mFileName);
+        const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, QDateTime(), QStringLiteral("before"));
+        snapshot.remove(call.handlerId);
+    }
+
+    LiveCallSnapshot snapshot(mFileName);
+    const Reclaimed call = snapshot.reclaim(ProviderId, Path, LineId, QDateTime(), QStringLiteral("after"));
+    QCOMPARE(call.handlerId, QStringLiteral("after"));
+    QVERIFY(!call.isReclaimed);
+}
+
+#include "tst_livecallsnapshot.moc"
+QTEST_MAIN(tst_livecallsnapshot)
@@ -0,0 +1,14 @@
+include(tests.pri)
+
+TARGET = tst_livecallsnapshot
+
+HEADERS += $$SRCDIR/livecallsnapshot.h
+
+SOURCES += $$SRCDIR/livecallsnapshot.cpp \
+    tst_livecallsnapshot.cpp
+
+tests_xml.path = /opt/tests/voicecall/manager
+tests_xml.files = tests.xml
+INSTALLS += tests_xml
+
+OTHER_FILES += tests.xml
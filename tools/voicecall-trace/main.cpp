@@ -0,0 +1,136 @@
+/*
+ * This file is a part of the Voice Call Manager project
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QFile>
+#include <QTextStream>
+
+#include <cstring>
+
+/*
+  Prints a trace dump, as written by VoiceCallTrace::dump(), as text.
+  Records are listed per thread, oldest first, stamped in milliseconds
+  before the dump. Dumps are read in host byte order, decode them on
+  the device that wrote them.
+*/
+namespace {
+
+class Reader
+{
+public:
+    explicit Reader(const QByteArray &data)
+        : m_data(data)
+    {
+    }
+
+    template <typename T> bool read(T *value)
+    {
+        if (m_offset + int(sizeof(T)) > m_data.size())
+            return false;
+        memcpy(value, m_data.constData() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool read(QByteArray *bytes, quint32 size)
+    {
+        if (size > quint32(m_data.size() - m_offset))
+            return false;
+        *bytes = m_data.mid(m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    bool atEnd() const
+    {
+        return m_offset == m_data.size();
+    }
+
+private:
+    QByteArray m_data;
+    int m_offset = 0;
+};
+
+bool decode(const QByteArray &data, QTextStream &out)
+{
+    Reader reader(data);
+    QByteArray magic;
+    quint32 version;
+    quint64 dumpedAt;
+    quint32 pid;
+    if (!reader.read(&magic, 4) || magic != "VCTR" || !reader.read(&version)
+            || version != 1 || !reader.read(&dumpedAt) || !reader.read(&pid)) {
+        return false;
+    }
+    out << "pid " << pid << '\n';
+
+    while (!reader.atEnd()) {
+        quint32 tid;
+        quint32 count;
+        if (!reader.read(&tid) || !reader.read(&count))
+            return false;
+        out << "thread " << tid << ", " << count << " records\n";
+
+        for (quint32 i = 0; i < count; i++) {
+            quint64 timestamp;
+            quint64 object;
+            quint32 line;
+            quint32 length;
+            QByteArray function;
+            if (!reader.read(&timestamp) || !reader.read(&object) || !reader.read(&line)
+                    || !reader.read(&length) || !reader.read(&function, length)) {
+                return false;
+            }
+            out << QString::number(-double(qint64(dumpedAt - timestamp)) / 1000000, 'f', 3).rightJustified(12)
+                << " ms  " << QString::fromUtf8(function) << ':' << line
+                << "  0x" << QString::number(object, 16) << '\n';
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (argc > 2) {
+        err << "usage: " << argv[0] << " [dump]\n"
+            << "Prints a voicecall-manager trace dump, read from standard input by default.\n";
+        return 2;
+    }
+
+    QFile file;
+    const bool opened = argc == 2
+            ? (file.setFileName(QFile::decodeName(argv[1])), file.open(QIODevice::ReadOnly))
+            : file.open(stdin, QIODevice::ReadOnly);
+    if (!opened) {
+        err << "cannot read " << (argc == 2 ? argv[1] : "standard input") << ": " << file.errorString() << '\n';
+        return 1;
+    }
+
+    if (!decode(file.readAll(), out)) {
+        out.flush();
+        err << "invalid or truncated trace dump\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,9 @@
+TARGET = voicecall-trace
+TEMPLATE = app
+QT = core
+
+SOURCES += main.cpp
+
+target.path = /usr/bin
+
+INSTALLS += target